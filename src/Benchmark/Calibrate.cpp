@@ -0,0 +1,152 @@
+/*
+ * mst_calibrate:
+ * Times the MST solvers on generated graphs and derives the AlgorithmThresholds used by `algo auto` on this
+ * machine. Build it optimized, run it once, and point MST_THRESHOLDS at the result:
+ *
+ *     ./mst_calibrate thresholds.txt
+ *     MST_THRESHOLDS=thresholds.txt ./server_LF
+ *
+ * Without an argument the thresholds are printed to stdout. The measurements go to stderr.
+ */
+#include "../Model/Graph.hpp"
+#include "../Model/MSTFactory.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int REPEATS = 3;
+
+// A random spanning path plus `extraEdges` random edges, weights in [0, maxWeight].
+static Graph sparseGraph(int n, int extraEdges, int maxWeight, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_int_distribution<int> weight(0, maxWeight);
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), rng);
+
+    Graph g(n);
+    for (int i = 1; i < n; ++i) {
+        g.add_edge(perm[i - 1], perm[i], weight(rng));
+    }
+    for (int i = 0; i < extraEdges; ++i) {
+        int u = vertex(rng), v = vertex(rng);
+        if (u != v) g.add_edge(u, v, weight(rng));
+    }
+    return g;
+}
+
+// Every pair is an edge with probability 1/divisor, plus a spanning path.
+static Graph denseGraph(int n, int divisor, unsigned seed) {
+    std::mt19937 rng(seed);
+    Graph g(n);
+    for (int u = 0; u < n; ++u) {
+        for (int v = u + 1; v < n; ++v) {
+            if (v == u + 1 || rng() % divisor == 0) g.add_edge(u, v, static_cast<int>(rng() % 100000));
+        }
+    }
+    return g;
+}
+
+// Best of REPEATS runs, in milliseconds.
+static double timeSolver(const std::string& name, int numThreads, Graph& g) {
+    std::unique_ptr<MSTFactory> solver = MSTFactory::create(name, numThreads);
+    double best = 0;
+    for (int run = 0; run < REPEATS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        Graph mst = solver->solveMST(g);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+// The fastest of `names` on `g`.
+static std::pair<std::string, double> fastest(const std::vector<std::string>& names, int numThreads, Graph& g) {
+    std::pair<std::string, double> best("", 0);
+    for (const std::string& name : names) {
+        double ms = timeSolver(name, numThreads, g);
+        std::cerr << "    " << name << ": " << ms << " ms\n";
+        if (best.first.empty() || ms < best.second) best = {name, ms};
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const std::vector<std::string> sequential = {"prim", "kruskal", "tarjan", "integer_mst"};
+    const std::vector<std::string> parallel = {"filter_kruskal", "boruvka"};
+    AlgorithmThresholds thresholds;
+
+    // Sparse graphs of growing size (average degree 16): where Prim stops winning, and where threads start to pay off.
+    thresholds.smallGraphEdges = 0;
+    thresholds.parallelMinEdges = INT_MAX;
+    bool primLeads = true;
+    for (int n = 256; n <= (1 << 17); n *= 4) {
+        Graph g = sparseGraph(n, 7 * n, 100000, n);
+        int E = g.getCSR().numEdges();
+        std::cerr << "sparse V=" << n << " E=" << E << "\n";
+        auto bestSequential = fastest(sequential, 1, g);
+        primLeads = primLeads && bestSequential.first == "prim";
+        if (primLeads) thresholds.smallGraphEdges = E;
+        if (cores > 1) {
+            auto bestParallel = fastest(parallel, cores, g);
+            if (bestParallel.second < bestSequential.second) {
+                thresholds.parallelMinEdges = std::min(thresholds.parallelMinEdges, E);
+                thresholds.parallelAlgorithm = bestParallel.first;
+            } else {
+                thresholds.parallelMinEdges = INT_MAX;
+            }
+        }
+    }
+
+    // Denser and denser graphs: from which density on Prim's array version wins.
+    const int denseVertices = 1024;
+    thresholds.denseRatioDivisor = 1;
+    for (int divisor = 2; divisor <= 64; divisor *= 2) {
+        Graph g = denseGraph(denseVertices, divisor, divisor);
+        std::cerr << "dense V=" << denseVertices << " E=" << g.getCSR().numEdges() << "\n";
+        if (fastest(sequential, 1, g).first != "prim") break;
+        thresholds.denseRatioDivisor = divisor;
+    }
+
+    // Weights too wide for the radix passes: the best comparison-based solver.
+    const std::vector<std::string> comparison = {"prim", "kruskal", "tarjan", "filter_kruskal"};
+    {
+        Graph g = sparseGraph(1 << 16, 7 << 16, INT_MAX / 2, 1);
+        std::cerr << "wide weights V=" << (1 << 16) << " E=" << g.getCSR().numEdges() << "\n";
+        thresholds.defaultAlgorithm = fastest(comparison, 1, g).first;
+    }
+
+    // Wider and wider weight ranges: up to which one the radix passes beat the comparison-based solvers.
+    // Beyond the solver's own limit it falls back to a comparison sort, so the search stops there.
+    const long long radixLimit = 1LL << (IntegerMSTSolver::RADIX_BITS * IntegerMSTSolver::MAX_RADIX_PASSES);
+    thresholds.integerMaxRange = 0;
+    for (long long range = 1 << 4; range < radixLimit; range <<= 3) {
+        Graph g = sparseGraph(1 << 16, 7 << 16, static_cast<int>(range), static_cast<unsigned>(range));
+        std::cerr << "weight range " << range << " V=" << (1 << 16) << " E=" << g.getCSR().numEdges() << "\n";
+        double integerMs = timeSolver("integer_mst", 1, g);
+        std::cerr << "    integer_mst: " << integerMs << " ms\n";
+        if (integerMs >= fastest(comparison, 1, g).second) break;
+        thresholds.integerMaxRange = range + 1; // Weights in [0, range].
+    }
+
+    if (argc > 1) {
+        std::ofstream out(argv[1]);
+        if (!out) {
+            std::cerr << "Cannot write " << argv[1] << std::endl;
+            return 1;
+        }
+        thresholds.save(out);
+    } else {
+        thresholds.save(std::cout);
+    }
+    return 0;
+}
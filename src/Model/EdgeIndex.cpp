@@ -0,0 +1,98 @@
+#include "EdgeIndex.hpp"
+#include <algorithm>
+
+namespace {
+// Number of slots allocated by the first insertion; the table doubles when it gets 3/4 full.
+const size_t INITIAL_CAPACITY = 16;
+const int INITIAL_SHIFT = 60;  // 64 - log2(INITIAL_CAPACITY)
+}
+
+// The table starts without slots, so empty graphs (and moved-from indexes) allocate nothing.
+EdgeIndex::EdgeIndex() : count(0), shift(64) {}
+
+// Packs the unordered pair {u, v} into one key, smaller endpoint in the high half.
+uint64_t EdgeIndex::pack(int u, int v) {
+    uint32_t lo = static_cast<uint32_t>(std::min(u, v));
+    uint32_t hi = static_cast<uint32_t>(std::max(u, v));
+    return (static_cast<uint64_t>(lo) << 32) | hi;
+}
+
+// Fibonacci hashing: multiply by 2^64 / phi and keep the top bits.
+size_t EdgeIndex::home(uint64_t key) const {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+
+// Returns the slot holding `key`, or the empty slot ending its probe run.
+size_t EdgeIndex::locate(uint64_t key) const {
+    size_t mask = slots.size() - 1;
+    size_t i = home(key);
+    while (slots[i].key != EMPTY && slots[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+EdgeIndex::Slot* EdgeIndex::find(int u, int v) {
+    if (count == 0) return nullptr;
+    size_t i = locate(pack(u, v));
+    return slots[i].key == EMPTY ? nullptr : &slots[i];
+}
+
+const EdgeIndex::Slot* EdgeIndex::find(int u, int v) const {
+    if (count == 0) return nullptr;
+    size_t i = locate(pack(u, v));
+    return slots[i].key == EMPTY ? nullptr : &slots[i];
+}
+
+void EdgeIndex::insert(int u, int v, Iterator atU, Iterator atV) {
+    if ((count + 1) * 4 > slots.size() * 3) grow();
+    uint64_t key = pack(u, v);
+    size_t i = locate(key);
+    if (slots[i].key == EMPTY) {
+        ++count;
+    }
+    slots[i] = u <= v ? Slot{key, atU, atV} : Slot{key, atV, atU};
+}
+
+bool EdgeIndex::erase(int u, int v) {
+    if (count == 0) return false;
+    size_t mask = slots.size() - 1;
+    size_t hole = locate(pack(u, v));
+    if (slots[hole].key == EMPTY) return false;
+
+    // Backward-shift deletion: move later entries of the run into the hole when their home slot allows it.
+    for (size_t i = (hole + 1) & mask; slots[i].key != EMPTY; i = (i + 1) & mask) {
+        size_t distanceToHome = (i - home(slots[i].key)) & mask;
+        size_t distanceToHole = (i - hole) & mask;
+        if (distanceToHome >= distanceToHole) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole].key = EMPTY;
+    --count;
+    return true;
+}
+
+void EdgeIndex::clear() {
+    slots.clear();
+    slots.shrink_to_fit();
+    count = 0;
+    shift = 64;
+}
+
+size_t EdgeIndex::size() const {
+    return count;
+}
+
+// Doubles the table (or allocates the first one) and reinserts every entry.
+void EdgeIndex::grow() {
+    std::vector<Slot> old(slots.empty() ? INITIAL_CAPACITY : slots.size() * 2, Slot{EMPTY, {}, {}});
+    old.swap(slots);
+    shift = old.empty() ? INITIAL_SHIFT : shift - 1;
+    for (const Slot& slot : old) {
+        if (slot.key != EMPTY) {
+            slots[locate(slot.key)] = slot;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef EDGEINDEX_HPP
+#define EDGEINDEX_HPP
+
+#include <vector>
+#include <list>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * EdgeIndex is an open-addressing hash table from an undirected edge to its two entries in the adjacency list.
+ *
+ * An edge (u, v) is stored twice in `Graph::adjList`: once in the list of u and once in the list of v. Finding
+ * either entry by walking the list is O(degree), which makes building a graph with high-degree vertices quadratic.
+ * The index keys each edge by the packed pair (min(u, v), max(u, v)) and remembers the list iterators of both
+ * entries, so a lookup, an insertion or an erasure costs O(1) on average.
+ *
+ * The slots live in one flat array probed linearly (no per-entry allocation, unlike `std::unordered_map`).
+ * Erasure shifts the following entries of the probe run back instead of leaving tombstones, so lookups never
+ * slow down after many removals. `std::list` iterators stay valid while other entries are inserted or erased,
+ * and when the whole adjacency vector is moved, but not when it is copied: a copied graph must rebuild its index.
+ */
+class EdgeIndex {
+public:
+    using Iterator = std::list<std::pair<int, int>>::iterator;
+
+    struct Slot {
+        uint64_t key;
+        Iterator lower;  // Entry in the list of min(u, v).
+        Iterator upper;  // Entry in the list of max(u, v).
+    };
+
+    EdgeIndex();
+    // Returns the slot of edge (u, v), or nullptr if the edge is not indexed.
+    Slot* find(int u, int v);
+    const Slot* find(int u, int v) const;
+    // Indexes edge (u, v), whose entries are `atU` in the list of u and `atV` in the list of v.
+    // Replaces the iterators if the edge is already indexed.
+    void insert(int u, int v, Iterator atU, Iterator atV);
+    // Removes edge (u, v) from the index. Returns false if it was not indexed.
+    bool erase(int u, int v);
+    // Removes every edge and releases the table.
+    void clear();
+    size_t size() const;
+
+private:
+    static constexpr uint64_t EMPTY = ~0ULL;
+    std::vector<Slot> slots;  // Empty, or power-of-two sized; EMPTY keys mark free slots.
+    size_t count;
+    int shift;                // 64 - log2(slots.size()), for Fibonacci hashing.
+
+    static uint64_t pack(int u, int v);
+    size_t home(uint64_t key) const;
+    size_t locate(uint64_t key) const;
+    void grow();
+};
+
+#endif // EDGEINDEX_HPP
@@ -1,5 +1,6 @@
 #include "Graph.hpp"
 #include "MSTFactory.hpp"
+#include "../Network/ThreadPool.hpp"
 #include <algorithm>
 #include <iostream>
 #include <limits>
@@ -7,24 +8,59 @@
 #include <functional>
 #include <sstream>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <charconv>
+#include <cstring>
 
 // Constructor to initialize a graph with a specified number of vertices.
-Graph::Graph(int vertices) : adjList(vertices) {}
+Graph::Graph(int vertices) : adjList(vertices), _version(nextVersion()) {}
 
 // Copy constructor
 Graph::Graph(const Graph& other)
-    : adjList(other.adjList), _algorithmChoice(other._algorithmChoice) {
+    : adjList(other.adjList), _algorithmChoice(other._algorithmChoice),
+      _csr(other._csr), _csrFrozen(other._csrFrozen),
+      _version(other._version), _solvedVersion(other._solvedVersion), _solvedAlgorithm(other._solvedAlgorithm),
+      _dynamicMST(other._dynamicMST), _forestReady(other._forestReady), _forestEdges(other._forestEdges) {
+    rebuildEdgeIndex();
     if (other.mst) {
         mst = std::make_unique<Graph>(*other.mst);
     }
+    if (other._msf) {
+        _msf = std::make_unique<Graph>(*other._msf);
+    }
+}
+
+// Move constructor. Moving the vector keeps the list nodes in place, so the edge index remains valid.
+Graph::Graph(Graph&& other) noexcept
+    : adjList(std::move(other.adjList)), _algorithmChoice(std::move(other._algorithmChoice)), mst(std::move(other.mst)),
+      _edgeIndex(std::move(other._edgeIndex)), _csr(std::move(other._csr)), _csrFrozen(other._csrFrozen),
+      _version(other._version), _solvedVersion(other._solvedVersion), _solvedAlgorithm(std::move(other._solvedAlgorithm)),
+      _dynamicMST(other._dynamicMST), _forestReady(other._forestReady), _forestEdges(other._forestEdges),
+      _msf(std::move(other._msf)) {
+    other.adjList.clear();
+    other._edgeIndex.clear();
+    other._csrFrozen = false;
+    other._version = nextVersion();
+    other._forestReady = false;
 }
 
 // Copy assignment operator
 Graph& Graph::operator=(const Graph& other) {
     if (this != &other) {
         adjList = other.adjList;
+        rebuildEdgeIndex();
         _algorithmChoice = other._algorithmChoice;
         mst = other.mst ? std::make_unique<Graph>(*other.mst) : nullptr;
+        _csr = other._csr;
+        _csrFrozen = other._csrFrozen;
+        _version = other._version;
+        _solvedVersion = other._solvedVersion;
+        _solvedAlgorithm = other._solvedAlgorithm;
+        _dynamicMST = other._dynamicMST;
+        _forestReady = other._forestReady;
+        _forestEdges = other._forestEdges;
+        _msf = other._msf ? std::make_unique<Graph>(*other._msf) : nullptr;
     }
     return *this;
 }
@@ -33,8 +69,23 @@ Graph& Graph::operator=(const Graph& other) {
 Graph& Graph::operator=(Graph&& other) noexcept {
     if (this != &other) {
         adjList = std::move(other.adjList);
+        _edgeIndex = std::move(other._edgeIndex);
+        other.adjList.clear();
+        other._edgeIndex.clear();
         _algorithmChoice = std::move(other._algorithmChoice);
         mst = std::move(other.mst);
+        _csr = std::move(other._csr);
+        _csrFrozen = other._csrFrozen;
+        other._csrFrozen = false;
+        _version = other._version;
+        _solvedVersion = other._solvedVersion;
+        _solvedAlgorithm = std::move(other._solvedAlgorithm);
+        other._version = nextVersion();
+        _dynamicMST = other._dynamicMST;
+        _forestReady = other._forestReady;
+        _forestEdges = other._forestEdges;
+        _msf = std::move(other._msf);
+        other._forestReady = false;
     }
     return *this;
 }
@@ -43,45 +94,83 @@ Graph& Graph::operator=(Graph&& other) noexcept {
 // If an edge already exists, it updates the weight.
 void Graph::add_edge(int u, int v, int weight) {
     if (isValidVertex(u) && isValidVertex(v)) {
-        // Remove the existing edge from u to v, if it exists
-        for (auto it = adjList[u].begin(); it != adjList[u].end(); ++it) {
-            if (it->first == v) {
-                adjList[u].erase(it);
-                break;
-            }
-        }
+        int oldWeight = 0;
+        bool hadEdge = insertEdge(u, v, weight, oldWeight);
+        touch();
+        updateForest(u, v, hadEdge, oldWeight, true, weight);
+    }
+}
 
-        // Remove the existing edge from v to u, if it exists
-        for (auto it = adjList[v].begin(); it != adjList[v].end(); ++it) {
-            if (it->first == u) {
-                adjList[v].erase(it);
-                break;
-            }
+// Adds a batch of edges with a single modification of the version stamp and a single MST rebuild.
+size_t Graph::add_edges(const WeightedEdge* edges, size_t count) {
+    size_t applied = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const WeightedEdge& edge = edges[i];
+        if (isValidVertex(edge.u) && isValidVertex(edge.v)) {
+            int oldWeight = 0;
+            insertEdge(edge.u, edge.v, edge.weight, oldWeight);
+            ++applied;
         }
+    }
+    if (applied == 0) return 0;
+    touch();
+    if (_forestReady) {
+        // Repairing the forest edge by edge would cost more than one rebuild: let the next Solve() rebuild it.
+        _forestReady = false;
+        _msf.reset();
+    }
+    return applied;
+}
+
+size_t Graph::add_edges(const std::vector<WeightedEdge>& edges) {
+    return add_edges(edges.data(), edges.size());
+}
 
-        // Add the new edge with the updated weight
-        adjList[u].push_back({v, weight});
-        adjList[v].push_back({u, weight});
+// Inserts edge (u, v) into the adjacency lists and the edge index, replacing an existing (u, v) edge.
+// Returns whether the edge existed, and its previous weight in `oldWeight`. Does not touch the version.
+bool Graph::insertEdge(int u, int v, int weight, int& oldWeight) {
+    bool hadEdge = false;
+
+    // Remove the existing edge (both directions), if it exists
+    if (EdgeIndex::Slot* slot = _edgeIndex.find(u, v)) {
+        hadEdge = true;
+        oldWeight = slot->lower->second;
+        adjList[std::min(u, v)].erase(slot->lower);
+        adjList[std::max(u, v)].erase(slot->upper);
     }
+
+    // Add the new edge with the updated weight
+    adjList[u].push_back({v, weight});
+    auto atU = std::prev(adjList[u].end());
+    adjList[v].push_back({u, weight});
+    _edgeIndex.insert(u, v, atU, std::prev(adjList[v].end()));
+    return hadEdge;
 }
 
 // Removes an undirected edge between vertices `u` and `v`.
 void Graph::remove_edge(int u, int v) {
     if (isValidVertex(u) && isValidVertex(v)) {
-        auto& neighborsU = adjList[u];
-        for (auto it = neighborsU.begin(); it != neighborsU.end(); ++it) {
-            if (it->first == v) {
-                neighborsU.erase(it);
-                break;
-            }
-        }
+        EdgeIndex::Slot* slot = _edgeIndex.find(u, v);
+        if (!slot) return;
+        int oldWeight = slot->lower->second;
+        adjList[std::min(u, v)].erase(slot->lower);
+        adjList[std::max(u, v)].erase(slot->upper);
+        _edgeIndex.erase(u, v);
+        touch();
+        updateForest(u, v, true, oldWeight, false, 0);
+    }
+}
 
-        auto& neighborsV = adjList[v];
-        for (auto it = neighborsV.begin(); it != neighborsV.end(); ++it) {
-            if (it->first == u) {
-                neighborsV.erase(it);
-                break;
-            }
+// Rebuilds the edge index from the adjacency list (after a copy, whose list nodes are new).
+// Vertices are visited in increasing order, so the entry of the smaller endpoint is always indexed first.
+void Graph::rebuildEdgeIndex() {
+    _edgeIndex.clear();
+    for (int u = 0; u < static_cast<int>(adjList.size()); ++u) {
+        for (auto it = adjList[u].begin(); it != adjList[u].end(); ++it) {
+            int v = it->first;
+            EdgeIndex::Slot* slot = _edgeIndex.find(u, v);
+            if (u < v || (u == v && !slot)) _edgeIndex.insert(u, v, it, it);
+            else if (slot) slot->upper = it;
         }
     }
 }
@@ -129,17 +218,214 @@ bool Graph::compareGraphs(Graph& other) {
 // Changes the weight of an existing undirected edge between vertices `u` and `v` to `newWeight`.
 void Graph::changeEdgeWeight(int u, int v, int newWeight) {
     if (isValidVertex(u) && isValidVertex(v)) {
-        for (auto& neighbor : adjList[u]) {
-            if (neighbor.first == v) {
-                neighbor.second = newWeight;
+        EdgeIndex::Slot* slot = _edgeIndex.find(u, v);
+        if (!slot) return;
+        int oldWeight = slot->lower->second;
+        slot->lower->second = newWeight;
+        slot->upper->second = newWeight;
+        touch();
+        updateForest(u, v, true, oldWeight, true, newWeight);
+    }
+}
+
+bool Graph::hasEdge(int u, int v) const {
+    return isValidVertex(u) && isValidVertex(v) && _edgeIndex.find(u, v) != nullptr;
+}
+
+bool Graph::getEdgeWeight(int u, int v, int& weight) const {
+    if (!isValidVertex(u) || !isValidVertex(v)) return false;
+    const EdgeIndex::Slot* slot = _edgeIndex.find(u, v);
+    if (!slot) return false;
+    weight = slot->lower->second;
+    return true;
+}
+
+// Selects the MST algorithm. Re-selecting the current algorithm leaves the MST and its analytics cached.
+void Graph::setAlgorithm(const std::string& algorithm) {
+    if (algorithm != _algorithmChoice) {
+        _algorithmChoice = algorithm;
+        _version = nextVersion();
+    }
+}
+
+const std::string& Graph::getAlgorithm() const {
+    return _algorithmChoice;
+}
+
+uint64_t Graph::getVersion() const {
+    return _version;
+}
+
+// Draws a new version stamp, unique across all graphs of the process.
+uint64_t Graph::nextVersion() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+// Marks the graph contents as modified: new version stamp and stale CSR snapshot.
+void Graph::touch() {
+    _version = nextVersion();
+    _csrFrozen = false;
+}
+
+// Stores `value` in a cache slot with the stamp it was computed for, and returns the cached copy.
+template <typename T>
+const T& Graph::remember(Cached<T>& slot, uint64_t stamp, T value) {
+    slot.stamp = stamp;
+    slot.value = std::move(value);
+    return slot.value;
+}
+
+// Rebuilds the CSR snapshot (offsets/targets/weights) from the adjacency list.
+// Does nothing if the graph has not been modified since the last freeze.
+void Graph::freeze() {
+    if (_csrFrozen) return;
+    int n = getNumVertices();
+
+    _csr.offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        _csr.offsets[u + 1] = _csr.offsets[u] + static_cast<int>(adjList[u].size());
+    }
+
+    _csr.targets.resize(_csr.offsets[n]);
+    _csr.weights.resize(_csr.offsets[n]);
+    for (int u = 0; u < n; ++u) {
+        int slot = _csr.offsets[u];
+        for (const auto& [v, weight] : adjList[u]) {
+            _csr.targets[slot] = v;
+            _csr.weights[slot] = weight;
+            ++slot;
+        }
+    }
+    _csrFrozen = true;
+}
+
+// Returns the CSR snapshot, freezing the graph first if it changed.
+const CSRGraph& Graph::getCSR() {
+    freeze();
+    return _csr;
+}
+
+// Enables or disables the in-place maintenance of the MST by the edge mutators.
+// The forest is (re)built by the next call to `Solve()`.
+void Graph::setDynamicMST(bool enabled) {
+    _dynamicMST = enabled;
+    _forestReady = false;
+    _msf.reset();
+}
+
+bool Graph::isDynamicMST() const {
+    return _dynamicMST;
+}
+
+// Returns the graph currently holding the minimum spanning forest.
+Graph& Graph::forest() {
+    return _msf ? *_msf : *mst;
+}
+
+// Moves the forest into `mst` when it spans the graph, or sets it aside (leaving an empty MST) when it does not.
+void Graph::publishForest() {
+    bool spanning = _forestEdges == getNumVertices() - 1;
+    if (spanning && _msf) {
+        mst = std::move(_msf);
+    } else if (!spanning && !_msf) {
+        _msf = std::move(mst);
+        mst = std::make_unique<Graph>(0);
+    }
+}
+
+// Breadth-first search in the forest from `source`, stopping early once `target` is reached (-1 explores the
+// whole tree). Records the BFS parent and parent-edge weight of every visited vertex, and the visit order.
+bool Graph::markForestComponent(int source, int target) {
+    const auto& tree = forest().adjList;
+    size_t n = adjList.size();
+    if (_mark.size() != n) {
+        _mark.assign(n, 0);
+        _trail.assign(n, -1);
+        _trailWeight.assign(n, 0);
+        _markStamp = 0;
+    }
+    ++_markStamp;
+
+    _visitOrder.clear();
+    _visitOrder.push_back(source);
+    _mark[source] = _markStamp;
+    _trail[source] = -1;
+    for (size_t head = 0; head < _visitOrder.size(); ++head) {
+        int x = _visitOrder[head];
+        if (x == target) return true;
+        for (const auto& [y, weight] : tree[x]) {
+            if (_mark[y] != _markStamp) {
+                _mark[y] = _markStamp;
+                _trail[y] = x;
+                _trailWeight[y] = weight;
+                _visitOrder.push_back(y);
             }
         }
-        for (auto& neighbor : adjList[v]) {
-            if (neighbor.first == u) {
-                neighbor.second = newWeight;
+    }
+    return false;
+}
+
+// Inserts the graph edge (u, v, weight) into the forest. If u and v are already connected, the edge closes a
+// cycle, and it replaces the heaviest edge of that cycle when it is lighter.
+void Graph::forestInsert(int u, int v, int weight) {
+    Graph& tree = forest();
+    if (!markForestComponent(u, v)) {
+        tree.add_edge(u, v, weight);
+        ++_forestEdges;
+        return;
+    }
+
+    int heaviest = v;
+    for (int x = v; x != u; x = _trail[x]) {
+        if (_trailWeight[x] > _trailWeight[heaviest]) heaviest = x;
+    }
+    if (_trailWeight[heaviest] > weight) {
+        tree.remove_edge(_trail[heaviest], heaviest);
+        tree.add_edge(u, v, weight);
+    }
+}
+
+// Removes the tree edge (u, v) from the forest and reconnects both halves with the lightest graph edge
+// crossing the cut, if there is one.
+void Graph::forestReplaceTreeEdge(int u, int v) {
+    Graph& tree = forest();
+    tree.remove_edge(u, v);
+    --_forestEdges;
+
+    markForestComponent(u, -1);
+    int bestU = -1, bestV = -1, bestWeight = std::numeric_limits<int>::max();
+    for (int x : _visitOrder) {
+        for (const auto& [y, weight] : adjList[x]) {
+            if (_mark[y] != _markStamp && (bestU == -1 || weight < bestWeight)) {
+                bestU = x;
+                bestV = y;
+                bestWeight = weight;
             }
         }
     }
+    if (bestU != -1) {
+        tree.add_edge(bestU, bestV, bestWeight);
+        ++_forestEdges;
+    }
+}
+
+// Called by the edge mutators once `adjList` is updated: repairs the forest for the change of edge (u, v).
+void Graph::updateForest(int u, int v, bool hadEdge, int oldWeight, bool hasEdge, int newWeight) {
+    if (!_dynamicMST || !_forestReady || u == v) return;
+
+    bool inTree = forest().hasEdge(u, v);
+
+    if (inTree) {
+        if (hasEdge && newWeight <= oldWeight) {
+            forest().changeEdgeWeight(u, v, newWeight); // A lighter tree edge stays in the tree.
+        } else {
+            forestReplaceTreeEdge(u, v);                // Deleted or heavier: it may be replaced.
+        }
+    } else if (hasEdge && (!hadEdge || newWeight < oldWeight)) {
+        forestInsert(u, v, newWeight);                  // New or lighter non-tree edge: cycle-max-edge swap.
+    }
+    publishForest();
 }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -148,272 +434,439 @@ void Graph::changeEdgeWeight(int u, int v, int newWeight) {
         ///////////////////////////////////////////////////////////////////////////////////////////////////////
         ///////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// Provides a textual representation of the graph, showing all vertices and edges with weights.
-std::string Graph::displayGraph() {
-    std::string graphRepresentation;
-    graphRepresentation +="\n" + std::string(15, ' ') + "---------------Graph Representation--------------------\n";
-    graphRepresentation += std::string(15, ' ') + "Vertices in the graph: ";
-    for (int i = 0; i < getNumVertices(); ++i) {
-        graphRepresentation += std::to_string(i) + " ";
+namespace {
+
+// Fixed-size staging buffer in front of a `TextSink`: the listings are formatted number by number with
+// `std::to_chars` and handed to the sink in chunks of `CAPACITY` bytes, instead of as one string per edge.
+class ChunkWriter {
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    explicit ChunkWriter(TextSink& sink) : sink(sink) {}
+    ~ChunkWriter() { flush(); }
+
+    void put(const char* text, size_t size) {
+        total += size;
+        if (size > CAPACITY - used) {
+            flush();
+            if (size > CAPACITY) {
+                sink.write(text, size);
+                return;
+            }
+        }
+        std::memcpy(buffer + used, text, size);
+        used += size;
     }
-    graphRepresentation += "\n" + std::string(15, ' ') + "Connections between vertices (undirected edges):\n";
-    for (int i = 0; i < getNumVertices(); ++i) {
-        for (const auto& neighbor : adjList[i]) {
-            if (i < neighbor.first) {
-                graphRepresentation += std::string(15, ' ') + "Vertex " + std::to_string(i) + " <----(" + std::to_string(neighbor.second) + ")----> Vertex " + std::to_string(neighbor.first) + "\n";
+    void put(const char* text) { put(text, std::strlen(text)); }
+    void put(const std::string& text) { put(text.data(), text.size()); }
+    void put(int value) {
+        if (CAPACITY - used < 11) flush(); // Longest int: "-2147483648".
+        size_t end = static_cast<size_t>(std::to_chars(buffer + used, buffer + CAPACITY, value).ptr - buffer);
+        total += end - used;
+        used = end;
+    }
+    // Bytes put since construction.
+    size_t written() const { return total; }
+    void flush() {
+        if (used > 0) sink.write(buffer, used);
+        used = 0;
+    }
+
+private:
+    TextSink& sink;
+    char buffer[CAPACITY];
+    size_t used = 0;
+    size_t total = 0;
+};
+
+const char* const GRAPH_TITLE = "\n               ---------------Graph Representation--------------------\n";
+const char* const MST_TITLE = "               ---------------MST Representation----------------------\n";
+
+// Writes the listing of `displayGraph()` / `displayMST()` for a snapshot, after the given title line, from `at` on.
+// Stops at the first line (or vertex number) boundary past `budget` bytes; returns true once the listing is complete.
+bool writeListing(TextSink& sink, const CSRGraph& csr, const char* title, ReportCursor::Position& at, size_t budget) {
+    const char* indent = "               "; // 15 spaces.
+    ChunkWriter out(sink);
+    if (at.part == 0) {
+        out.put(title);
+        out.put(indent);
+        out.put("Vertices in the graph: ");
+        at.part = 1;
+    }
+    if (at.part == 1) {
+        for (; at.vertex < csr.numVertices(); ++at.vertex) {
+            if (out.written() >= budget) return false;
+            out.put(at.vertex);
+            out.put(" ", 1);
+        }
+        out.put("\n");
+        out.put(indent);
+        out.put("Connections between vertices (undirected edges):\n");
+        at = {2, 0, 0};
+    }
+    for (; at.vertex < csr.numVertices(); ++at.vertex) {
+        int i = at.vertex;
+        for (at.edge = std::max(at.edge, csr.begin(i)); at.edge < csr.end(i); ++at.edge) {
+            int e = at.edge;
+            if (i < csr.targets[e]) {
+                if (out.written() >= budget) return false;
+                out.put(indent);
+                out.put("Vertex ");
+                out.put(i);
+                out.put(" <----(");
+                out.put(csr.weights[e]);
+                out.put(")----> Vertex ");
+                out.put(csr.targets[e]);
+                out.put("\n", 1);
             }
         }
     }
-    return graphRepresentation;
+    return true;
+}
+
+} // namespace
+
+// Provides a textual representation of the graph, showing all vertices and edges with weights.
+std::string Graph::displayGraph() {
+    if (_displayGraph.stamp == _version) return _displayGraph.value;
+    std::string graphRepresentation;
+    StringSink sink(graphRepresentation);
+    writeGraph(sink);
+    return remember(_displayGraph, _version, std::move(graphRepresentation));
 }
 
 // Provides a textual representation of MST
 std::string Graph::displayMST() {
+    if (_displayMST.stamp == this->mst->_version) return _displayMST.value;
     std::string graphRepresentation;
-    graphRepresentation += std::string(15, ' ') + "---------------MST Representation----------------------\n";
-    graphRepresentation += std::string(15, ' ') + "Vertices in the graph: ";
-    for (int i = 0; i < this->mst->getNumVertices(); ++i) {
-        graphRepresentation += std::to_string(i) + " ";
-    }
-    graphRepresentation += "\n" + std::string(15, ' ') + "Connections between vertices (undirected edges):\n";
-    for (int i = 0; i < this->mst->getNumVertices(); ++i) {
-        for (const auto& neighbor : this->mst->adjList[i]) {
-            if (i < neighbor.first) {
-                graphRepresentation += std::string(15, ' ') + "Vertex " + std::to_string(i) + " <----(" + std::to_string(neighbor.second) + ")----> Vertex " + std::to_string(neighbor.first) + "\n";
-            }
-        }
-    }
-    return graphRepresentation;
+    StringSink sink(graphRepresentation);
+    writeMST(sink);
+    return remember(_displayMST, this->mst->_version, std::move(graphRepresentation));
+}
+
+void Graph::writeGraph(TextSink& sink) {
+    ReportCursor::Position start;
+    writeListing(sink, getCSR(), GRAPH_TITLE, start, SIZE_MAX);
+}
+
+void Graph::writeMST(TextSink& sink) {
+    ReportCursor::Position start;
+    writeListing(sink, this->mst->getCSR(), MST_TITLE, start, SIZE_MAX);
 }
 
 // Returns the total weight of all edges in the graph.
 double Graph::getTotalWeight() {
+    const CSRGraph& csr = getCSR();
     double totalWeight = 0;
-    for (int u = 0; u < getNumVertices(); ++u) {
-        for (const auto& neighbor : adjList[u]) {
-            totalWeight += neighbor.second;  // Add the edge weight.
-        }
+    for (int weight : csr.weights) {
+        totalWeight += weight;  // Add the edge weight.
     }
     return totalWeight / 2;
 }
 
 // Returns the total weight of all edges in the graph.
 double Graph::getTotalWeight_MST() {
-    double totalWeight = 0;
-    for (int u = 0; u < this->mst->getNumVertices(); ++u) {
-        for (const auto& neighbor : this->mst->adjList[u]) {
-            totalWeight += neighbor.second;  // Add the edge weight.
-        }
-    }
-    return totalWeight / 2;
+    return analyzeMST(false).totalWeight;
 }
 
 // Finds the longest path in the MST and returns it as a formatted string.
 std::string Graph::getTreeDepthPath_MST() {
-    int n = this->mst->getNumVertices();
-    if (n == 0) return "";
-
-    std::vector<int> path;
-    std::vector<int> parents(n, -1); // Declare parents array to store traversal path.
-
-    // Lambda function to find the farthest node from a given starting node.
-    auto farthestFrom = [&](int start) {
-        std::vector<bool> visited(n, false);
-        std::vector<int> distance(n, 0);
-        int maxDistance = 0, farthestNode = start;
-
-        std::function<void(int)> dfs = [&](int node) {
-            visited[node] = true;
-            for (const auto& neighbor : this->mst->adjList[node]) {
-                int v = neighbor.first;
-                if (!visited[v]) {
-                    parents[v] = node;
-                    distance[v] = distance[node] + 1;
-                    dfs(v);
-                    if (distance[v] > maxDistance) {
-                        maxDistance = distance[v];
-                        farthestNode = v;
-                    }
-                }
-            }
-        };
-        dfs(start);
-
-        // Build the path from the starting node to the farthest node.
-        path.clear();
-        for (int v = farthestNode; v != -1; v = parents[v])
-            path.push_back(v);
-        std::reverse(path.begin(), path.end());
-        return maxDistance;
-    };
-    farthestFrom(0); // Find the deepest path.
-
-    // Convert the path to a formatted string "0->9->..."
-    std::ostringstream oss;
-    for (size_t i = 0; i < path.size(); ++i) {
-        oss << path[i];
-        if (i < path.size() - 1) oss << "->";
-    }
-    return oss.str();
+    if (_depthPathMST.stamp == this->mst->_version) return _depthPathMST.value;
+    return remember(_depthPathMST, this->mst->_version, formatLongestPath(analyzeMST(false)));
 }
 
 // Retrieves the heaviest edge in the MST as a formatted string "u v w".
 std::string Graph::getMaxWeightEdge_MST() {
-    int maxWeightEdge = 0;
-    int u = -1, v = -1;
-    for (int i = 0; i < this->mst->getNumVertices(); ++i) {
-        for (const auto& edge : this->mst->adjList[i]) {
-            if (edge.second > maxWeightEdge) {
-                maxWeightEdge = edge.second;
-                u = i;
-                v = edge.first;
-            }
-        }
-    }
-    std::ostringstream oss;
-    oss << "Vertex " << u << " <----(" << maxWeightEdge << ")----> Vertex " << v;
-    return oss.str();
+    if (_maxWeightEdgeMST.stamp == this->mst->_version) return _maxWeightEdgeMST.value;
+    return remember(_maxWeightEdgeMST, this->mst->_version, formatEdge(analyzeMST(false).heaviestEdge));
 }
 
 // Finds the heaviest path in the MST and returns it as a formatted string.
 std::string Graph::getMaxWeightPath_MST() {
+    if (_maxWeightPathMST.stamp == this->mst->_version) return _maxWeightPathMST.value;
+    return remember(_maxWeightPathMST, this->mst->_version, formatHeaviestPath(analyzeMST(false)));
+}
 
-    int n = this->mst->getNumVertices();
-    if (n == 0) return "Empty graph";
-
-    std::vector<int> parents(n, -1);
-
-    // Lambda function to find the farthest node from a given starting point.
-    auto farthestFrom = [&](int start) {
-        std::vector<bool> visited(n, false);
-        std::vector<int> distance(n, 0);
-        int maxDistance = 0, farthestNode = start;
-
-        std::function<void(int)> dfs = [&](int node) {
-            visited[node] = true;
-            for (const auto& neighbor : this->mst->adjList[node]) {
-                int v = neighbor.first;
-                int weight = neighbor.second;
-                if (!visited[v]) {
-                    parents[v] = node;
-                    distance[v] = distance[node] + weight;
-                    dfs(v);
-                    if (distance[v] > maxDistance) {
-                        maxDistance = distance[v];
-                        farthestNode = v;
-                    }
-                }
-            }
-        };
-        dfs(start);
-        return farthestNode;
+// Walks every component with a `TreeWalker`, so that path-like trees of any depth are handled.
+// Every statistic that only needs each half-edge once, or each vertex once, is gathered during the first pass.
+TreeSummary Graph::summarizeTree(const CSRGraph& tree) {
+    TreeSummary summary;
+    int n = tree.numVertices();
+    if (n == 0) return summary;
+
+    TreeWalker walker(n);
+    const std::vector<int>& parent = walker.parent;
+    const std::vector<int>& parentWeight = walker.parentWeight;
+    const std::vector<int>& hops = walker.hops;
+    const std::vector<long long>& distance = walker.distance;
+    std::vector<int> subtreeSize(n, 1), order;
+    order.reserve(n);
+    int maxEdge = -1, minEdge = -1;
+    double weightSum = 0;
+
+    // Pass 1. Ties go to the first vertex in post-order, and to the first half-edge in CSR order.
+    int deepest = 0, farthest = 0;
+    long long farthestDistance = 0;
+    auto edgeStatistics = [&](int e) {
+        int weight = tree.weights[e];
+        weightSum += weight;
+        if (weight > summary.maxEdgeWeight || (weight == summary.maxEdgeWeight && maxEdge >= 0 && e < maxEdge)) {
+            summary.maxEdgeWeight = weight;
+            maxEdge = e;
+        }
+        if (weight < summary.minEdgeWeight || (weight == summary.minEdgeWeight && minEdge >= 0 && e < minEdge)) {
+            summary.minEdgeWeight = weight;
+            minEdge = e;
+        }
     };
-
-    // Find the two ends of the heaviest path.
-    int start = farthestFrom(0);
-
-    // Reset `parents` for the second search.
-    std::fill(parents.begin(), parents.end(), -1);
-    int end = farthestFrom(start);
-
-    // Rebuild the path as a list of vertex-weight pairs.
-    std::vector<std::pair<int, int>> maxPath;
-    for (int v = end; v != -1; v = parents[v]) {
-        if (parents[v] != -1) {
-            int u = parents[v];
-            auto it = std::find_if(this->mst->adjList[u].begin(), this->mst->adjList[u].end(),
-                                   [v](const std::pair<int, int>& edge) { return edge.first == v; });
-            if (it != this->mst->adjList[u].end()) {
-                maxPath.push_back({u, it->second});
+    for (int root = 0; root < n; ++root) {
+        if (walker.reachedEver(root)) continue;
+        size_t componentStart = order.size();
+        walker.walk(tree, root, [&](int node) { order.push_back(node); }, edgeStatistics, [&](int node) {
+            if (root != 0) return;
+            if (hops[node] > hops[deepest]) deepest = node;
+            if (distance[node] > farthestDistance) {
+                farthestDistance = distance[node];
+                farthest = node;
             }
+        });
+
+        // Children appear after their parent in pre-order, so a reverse scan accumulates subtree sizes bottom-up.
+        // Every path crossing the edge (parent(v), v) uses it exactly once, and there are
+        // size(v) * (componentSize - size(v)) such pairs.
+        long long componentSize = static_cast<long long>(order.size() - componentStart);
+        for (size_t i = order.size() - 1; i > componentStart; --i) {
+            int v = order[i];
+            subtreeSize[parent[v]] += subtreeSize[v];
+            summary.distanceSum += static_cast<double>(parentWeight[v]) * subtreeSize[v] * (componentSize - subtreeSize[v]);
         }
-    }
-    std::reverse(maxPath.begin(), maxPath.end());
+        summary.pairCount += componentSize * (componentSize - 1) / 2;
 
-    // Build a formatted string representation of the heaviest path.
-    std::ostringstream oss;
-    oss << "Heaviest path: ";
-    for (size_t i = 0; i < maxPath.size(); ++i) {
-        oss << maxPath[i].first << " --(" << maxPath[i].second << ")--> ";
+        if (root == 0) {
+            for (int v = deepest; v != -1; v = parent[v]) summary.depthPath.push_back(v);
+            std::reverse(summary.depthPath.begin(), summary.depthPath.end());
+        }
     }
-    oss << end;
+    summary.totalWeight = weightSum / 2;
 
-    return oss.str();
-}
+    // Owners of the extreme half-edges: the vertex whose CSR range holds them.
+    if (maxEdge >= 0) {
+        summary.maxEdgeU = static_cast<int>(std::upper_bound(tree.offsets.begin(), tree.offsets.end(), maxEdge) - tree.offsets.begin()) - 1;
+        summary.maxEdgeV = tree.targets[maxEdge];
+    }
+    if (minEdge >= 0) {
+        summary.minEdgeU = static_cast<int>(std::upper_bound(tree.offsets.begin(), tree.offsets.end(), minEdge) - tree.offsets.begin()) - 1;
+        summary.minEdgeV = tree.targets[minEdge];
+    }
 
-// Calculates the average distance between all vertex pairs in the MST.
-double Graph::getAverageDistance_MST() {
-    int n = this->mst->getNumVertices();
-    std::vector<std::vector<int>> dist(n, std::vector<int>(n, std::numeric_limits<int>::max()));
-    for (int i = 0; i < n; ++i) {
-        dist[i][i] = 0;
-        for (const auto& neighbor : this->mst->adjList[i]) {
-            int v = neighbor.first;
-            int weight = neighbor.second;
-            dist[i][v] = weight;
+    // Pass 2: the vertex farthest from `farthest` ends the heaviest path.
+    int end = farthest;
+    long long endDistance = 0;
+    walker.walk(tree, farthest, [](int) {}, [](int) {}, [&](int node) {
+        if (distance[node] > endDistance) {
+            endDistance = distance[node];
+            end = node;
         }
+    });
+    for (int v = end; v != -1; v = parent[v]) {
+        summary.heaviestPath.push_back(v);
+        if (parent[v] != -1) summary.heaviestPathWeights.push_back(parentWeight[v]);
     }
+    std::reverse(summary.heaviestPath.begin(), summary.heaviestPath.end());
+    std::reverse(summary.heaviestPathWeights.begin(), summary.heaviestPathWeights.end());
+    return summary;
+}
 
-    // Use Floyd-Warshall algorithm to compute shortest distances between all pairs.
-    for (int k = 0; k < n; ++k)
-        for (int i = 0; i < n; ++i)
-            for (int j = 0; j < n; ++j)
-                if (dist[i][k] < std::numeric_limits<int>::max() && dist[k][j] < std::numeric_limits<int>::max())
-                    dist[i][j] = std::min(dist[i][j], dist[i][k] + dist[k][j]);
-
-    // Calculate the average of the pairwise distances.
-    int sumDistances = 0, count = 0;
-    for (int i = 0; i < n; ++i)
-        for (int j = i + 1; j < n; ++j)
-            if (dist[i][j] < std::numeric_limits<int>::max()) {
-                sumDistances += dist[i][j];
-                ++count;
-            }
+// Sums the distances between all pairs of connected vertices of a tree (or forest) in O(V), with the subtree
+// sizes of `summarizeTree`.
+double Graph::sumTreeDistances(const CSRGraph& tree, long long& pairCount) {
+    TreeSummary summary = summarizeTree(tree);
+    pairCount = summary.pairCount;
+    return summary.distanceSum;
+}
 
-    return count > 0 ? static_cast<double>(sumDistances) / count : 0.0;
+// Calculates the average distance between all vertex pairs in the MST.
+double Graph::getAverageDistance_MST() {
+    return analyzeMST(false).averageDistance;
 }
 
 // Retrieves the lightest edge in the MST as a formatted string "Vertex u <----(w)----> Vertex v".
 std::string Graph::getMinWeightEdge_MST() {
-    int minWeightEdge = std::numeric_limits<int>::max();
-    int u = -1, v = -1;
-    for (int i = 0; i < this->mst->getNumVertices(); ++i) {
-        for (const auto& edge : this->mst->adjList[i]) {
-            if (edge.second < minWeightEdge) {
-                minWeightEdge = edge.second;
-                u = i;
-                v = edge.first;
+    if (_minWeightEdgeMST.stamp == this->mst->_version) return _minWeightEdgeMST.value;
+    return remember(_minWeightEdgeMST, this->mst->_version, formatEdge(analyzeMST(false).lightestEdge));
+}
+
+// Computes the MST result. The tree statistics come from one `summarizeTree` run, and the edge list from one
+// scan of the CSR snapshot; both only read the frozen snapshot, so on large trees the summary runs as a forked
+// task while the calling thread lists the edges.
+const MSTResult& Graph::analyzeMST(bool parallel) {
+    if (_resultMST.stamp == this->mst->_version) return _resultMST.value;
+    const CSRGraph& tree = this->mst->getCSR(); // Freezes once up front: the task must only read the snapshot.
+    MSTResult result;
+    TreeSummary summary;
+    auto listEdges = [&tree, &result]() {
+        result.edges.reserve(tree.numEdges());
+        for (int u = 0; u < tree.numVertices(); ++u) {
+            for (int e = tree.begin(u); e < tree.end(u); ++e) {
+                if (u < tree.targets[e]) result.edges.push_back({u, tree.targets[e], tree.weights[e]});
             }
         }
+    };
+    if (parallel && tree.numVertices() >= PARALLEL_ANALYSIS_MIN_VERTICES) {
+        TaskGroup group;
+        group.run([&tree, &summary]() { summary = summarizeTree(tree); });
+        listEdges();
+        group.wait();
+    } else {
+        summary = summarizeTree(tree);
+        listEdges();
     }
+
+    result.vertices = tree.numVertices();
+    result.totalWeight = summary.totalWeight;
+    result.averageDistance = summary.pairCount > 0 ? summary.distanceSum / summary.pairCount : 0.0;
+    result.longestPath = std::move(summary.depthPath);
+    result.heaviestPath = std::move(summary.heaviestPath);
+    result.heaviestPathWeights = std::move(summary.heaviestPathWeights);
+    result.heaviestEdge = {summary.maxEdgeU, summary.maxEdgeV, summary.maxEdgeWeight};
+    result.lightestEdge = {summary.minEdgeU, summary.minEdgeV, summary.minEdgeWeight};
+    return remember(_resultMST, this->mst->_version, std::move(result));
+}
+
+// Formats an edge as "Vertex u <----(w)----> Vertex v".
+std::string Graph::formatEdge(const WeightedEdge& edge) {
     std::ostringstream oss;
-    oss << "Vertex " << u << " <----(" << minWeightEdge << ")----> Vertex " << v;
+    oss << "Vertex " << edge.u << " <----(" << edge.weight << ")----> Vertex " << edge.v;
     return oss.str();
 }
 
+// Formats the longest path as "0->9->...", or "" for an empty MST.
+std::string Graph::formatLongestPath(const MSTResult& result) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < result.longestPath.size(); ++i) {
+        oss << result.longestPath[i];
+        if (i < result.longestPath.size() - 1) oss << "->";
+    }
+    return oss.str();
+}
+
+// Formats the heaviest path as "Heaviest path: u --(w)--> v ...", or "Empty graph" for an empty MST.
+std::string Graph::formatHeaviestPath(const MSTResult& result) {
+    if (result.heaviestPath.empty()) return "Empty graph";
+    std::ostringstream oss;
+    oss << "Heaviest path: ";
+    for (size_t i = 0; i < result.heaviestPathWeights.size(); ++i) {
+        oss << result.heaviestPath[i] << " --(" << result.heaviestPathWeights[i] << ")--> ";
+    }
+    oss << result.heaviestPath.back();
+    return oss.str();
+}
+
+std::string Graph::formatAnalysis(const std::string& algorithm, const MSTResult& result) {
+    std::string section;
+    section += std::string(15, ' ') + "------------------MST Analysis-------------------------\n";
+    section += std::string(15, ' ') + "Algorithm: " + algorithm + "\n";
+    section += std::string(15, ' ') + "Total MST weight: " + std::to_string(result.totalWeight) + "\n";
+    section += std::string(15, ' ') + "Average distance: " + std::to_string(result.averageDistance) + "\n";
+    section += std::string(15, ' ') + "Longest path: " + formatLongestPath(result) + "\n";
+    section += std::string(15, ' ') + "Heaviest path: " + formatHeaviestPath(result) + "\n";
+    section += std::string(15, ' ') + "Heaviest edge: " + formatEdge(result.heaviestEdge) + "\n";
+    section += std::string(15, ' ') + "Lightest edge: " + formatEdge(result.lightestEdge) + "\n";
+    section += std::string(15, ' ') + "-------------------------------------------------------\n";
+    return section;
+}
+
 std::string Graph::Analysis() {
+    // The report depends on the graph (displayGraph), the MST and the algorithm name.
+    if (_analysis.stamp == _version && _analysisMSTVersion == this->mst->_version && _analysisAlgorithm == _algorithmChoice) {
+        return _analysis.value;
+    }
+    if (this->mst->getNumVertices() >= PARALLEL_ANALYSIS_MIN_VERTICES) {
+        // The two listings are built alongside the result.
+        freeze();
+        this->mst->freeze();
+        TaskGroup group;
+        group.run([this]() { displayGraph(); });
+        group.run([this]() { displayMST(); });
+        analyzeMST();
+        group.wait();
+    }
     std::string _Analysis = "";
     _Analysis +="\n"+displayGraph() + displayMST();
-    _Analysis += std::string(15, ' ') + "------------------MST Analysis-------------------------\n";
-    _Analysis += std::string(15, ' ') + "Algorithm: " + _algorithmChoice + "\n";
-    _Analysis += std::string(15, ' ') + "Total MST weight: " + std::to_string(getTotalWeight_MST()) + "\n";
-    _Analysis += std::string(15, ' ') + "Average distance: " + std::to_string(getAverageDistance_MST()) + "\n";
-    _Analysis += std::string(15, ' ') + "Longest path: " + getTreeDepthPath_MST() + "\n";
-    _Analysis += std::string(15, ' ') + "Heaviest path: " + getMaxWeightPath_MST() + "\n";
-    _Analysis += std::string(15, ' ') + "Heaviest edge: " + getMaxWeightEdge_MST() + "\n";
-    _Analysis += std::string(15, ' ') + "Lightest edge: " + getMinWeightEdge_MST() + "\n";
-    _Analysis += std::string(15, ' ') + "-------------------------------------------------------\n";
-    return _Analysis;
+    _Analysis += formatAnalysis(_algorithmChoice, analyzeMST(false));
+    _analysisMSTVersion = this->mst->_version;
+    _analysisAlgorithm = _algorithmChoice;
+    return remember(_analysis, _version, std::move(_Analysis));
+}
+
+void Graph::writeAnalysis(TextSink& sink) {
+    if (this->mst->getNumVertices() >= PARALLEL_ANALYSIS_MIN_VERTICES) {
+        // The result is computed on the pool while the listings are written (possibly waiting for the client).
+        freeze();
+        this->mst->freeze();
+        TaskGroup group;
+        group.run([this]() { analyzeMST(); });
+        sink.write("\n", 1);
+        writeGraph(sink);
+        writeMST(sink);
+        group.wait();
+    } else {
+        sink.write("\n", 1);
+        writeGraph(sink);
+        writeMST(sink);
+    }
+    sink.write(formatAnalysis(_algorithmChoice, analyzeMST(false)));
+}
+
+ReportCursor::ReportCursor(Graph& graph) : graph(graph) {}
+
+bool ReportCursor::next(TextSink& sink, size_t budget) {
+    switch (section) {
+        case Section::Start:
+            sink.write("\n", 1);
+            section = Section::GraphListing;
+            return true;
+        case Section::GraphListing:
+            if (writeListing(sink, graph.getCSR(), GRAPH_TITLE, position, budget)) {
+                position = Position();
+                section = Section::MSTListing;
+            }
+            return true;
+        case Section::MSTListing:
+            if (writeListing(sink, graph.mst->getCSR(), MST_TITLE, position, budget)) section = Section::Analysis;
+            return true;
+        case Section::Analysis:
+            sink.write(Graph::formatAnalysis(graph.getAlgorithm(), graph.analyzeMST()));
+            section = Section::Done;
+            return false;
+        case Section::Done:
+            break;
+    }
+    return false;
 }
 
 void Graph::Solve() {
     if (this->getNumVertices() == 0) {return ;}
-    std::unique_ptr<MSTFactory> algo;
-    if (_algorithmChoice == "prim") algo = std::make_unique<PrimSolver>();
-    else if (_algorithmChoice == "kruskal") algo = std::make_unique<KruskalSolver>();
-    else if (_algorithmChoice == "boruvka") algo = std::make_unique<BoruvkaSolver>();
-    else if (_algorithmChoice == "tarjan") algo = std::make_unique<TarjanSolver>();
-    else if (_algorithmChoice == "integer_mst") algo = std::make_unique<IntegerMSTSolver>();
+    // Nothing changed since the last run: keep the current MST (and its cached analytics).
+    // In dynamic mode the edge mutators already keep `mst` up to date.
+    bool upToDate = _dynamicMST ? _forestReady : _solvedVersion == _version;
+    if (this->mst && upToDate && _solvedAlgorithm == _algorithmChoice) {return ;}
+    freeze(); // Solvers read the contiguous CSR snapshot instead of walking the adjacency lists.
+    std::unique_ptr<MSTFactory> algo = MSTFactory::create(_algorithmChoice, static_cast<int>(std::thread::hardware_concurrency()));
     if (!algo) {return;}
         this->mst = std::make_unique<Graph>(algo->solveMST(*this));
+    _solvedVersion = _version;
+    _solvedAlgorithm = _algorithmChoice;
+
+    if (_dynamicMST) {
+        // Seed the forest maintained by the mutators. A disconnected graph has no MST,
+        // so its minimum spanning forest is kept aside until an edge connects it.
+        _msf.reset();
+        _forestEdges = this->mst->getCSR().numEdges();
+        if (this->mst->getNumVertices() != this->getNumVertices()) {
+            _msf = std::make_unique<Graph>(KruskalSolver::solveForest(*this));
+            _forestEdges = _msf->getCSR().numEdges();
+        }
+        _forestReady = true;
+    }
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include <memory>
 #include <utility>
 #include <string>
+#include <cstdint>
+#include <climits>
+#include "EdgeIndex.hpp"
 
 /*
  * The Graph class represents an undirected weighted graph using an adjacency list structure.
@@ -36,14 +39,226 @@
  *  - This structure is efficient for quickly accessing the neighbors of any vertex and is widely used in graph algorithms.
  */
 
+/*
+ * CSRGraph is a read-only, contiguous snapshot of an adjacency list in Compressed Sparse Row form.
+ *
+ * The adjacency list is convenient for mutations (add/remove/change an edge), but every edge lives in its own
+ * heap-allocated list node, so walking it chases pointers and misses the cache. Before running an MST solver or
+ * an analysis function, the graph is "frozen" into three flat arrays:
+ *    • `offsets` (size V + 1): the neighbors of vertex `u` are stored at indices [offsets[u], offsets[u + 1]).
+ *    • `targets` (size 2E): the neighboring vertex of each directed half-edge.
+ *    • `weights` (size 2E): the weight of each directed half-edge.
+ * Neighbors keep the same order as in the adjacency list. For the example above:
+ *      offsets -> {0, 2, 4, 6}
+ *      targets -> {1, 2, 0, 2, 0, 1}
+ *      weights -> {3, 7, 3, 5, 7, 5}
+ */
+struct CSRGraph {
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> weights;
+
+    // Returns the number of vertices in the snapshot.
+    int numVertices() const { return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1; }
+    // Returns the number of undirected edges in the snapshot.
+    int numEdges() const { return static_cast<int>(targets.size() / 2); }
+    // Index range of the half-edges leaving vertex `u`.
+    int begin(int u) const { return offsets[u]; }
+    int end(int u) const { return offsets[u + 1]; }
+    int degree(int u) const { return offsets[u + 1] - offsets[u]; }
+};
+
+/*
+ * TreeWalker is an explicit-stack depth-first traversal of a CSR snapshot, for trees and forests of any depth.
+ *
+ * A recursive DFS uses one call frame per tree level, so a path-like MST of a few hundred thousand vertices
+ * overflows the (small) stack of a worker thread. Here, each vertex on the stack keeps a cursor on its next
+ * half-edge instead, and is finished once its cursor reaches the end of its neighbors: the vertices are
+ * discovered and finished in the same order as a recursive DFS would, with O(V) heap memory.
+ * While walking, it records for every reached vertex its parent, the weight of the edge to its parent, and
+ * its depth from the root in hops and in weight. The arrays are kept between walks, and each walk is
+ * numbered, so consecutive walks (on different components, or from different roots) reuse them without reset.
+ */
+struct TreeWalker {
+    std::vector<int> mark, cursor, parent, parentWeight, hops, stack;
+    std::vector<long long> distance;
+    int walks = 0;
+
+    explicit TreeWalker(int n) : mark(n, 0), cursor(n), parent(n, -1), parentWeight(n, 0), hops(n, 0), distance(n, 0) {}
+
+    // Returns whether `v` was reached by any walk so far.
+    bool reachedEver(int v) const { return mark[v] != 0; }
+
+    /* Walks the component of `root` in `tree`. `onDiscover(v)` is called in pre-order and `onFinish(v)` in
+     * post-order; `onHalfEdge(e)` is called for every half-edge of the component, in CSR order per vertex.
+     * The callbacks are template parameters, so they are inlined instead of going through `std::function`. */
+    template <typename Discover, typename HalfEdge, typename Finish>
+    void walk(const CSRGraph& tree, int root, Discover&& onDiscover, HalfEdge&& onHalfEdge, Finish&& onFinish) {
+        int pass = ++walks;
+        mark[root] = pass;
+        parent[root] = -1;
+        parentWeight[root] = 0;
+        hops[root] = 0;
+        distance[root] = 0;
+        cursor[root] = tree.begin(root);
+        stack.push_back(root);
+        onDiscover(root);
+        while (!stack.empty()) {
+            int node = stack.back();
+            if (cursor[node] == tree.end(node)) {
+                stack.pop_back();
+                onFinish(node);
+                continue;
+            }
+            int e = cursor[node]++;
+            onHalfEdge(e);
+            int v = tree.targets[e];
+            if (mark[v] != pass) {
+                mark[v] = pass;
+                parent[v] = node;
+                parentWeight[v] = tree.weights[e];
+                hops[v] = hops[node] + 1;
+                distance[v] = distance[node] + tree.weights[e];
+                cursor[v] = tree.begin(v);
+                stack.push_back(v);
+                onDiscover(v);
+            }
+        }
+    }
+};
+
+/*
+ * Everything the MST analytics need about a tree (or forest), computed by `Graph::summarizeTree` in two
+ * iterative depth-first passes over its CSR snapshot.
+ * Paths are taken in the component of vertex 0, which is the whole tree for an MST.
+ */
+struct TreeSummary {
+    double totalWeight = 0;
+    double distanceSum = 0;    // Sum of the distances between all pairs of connected vertices.
+    long long pairCount = 0;   // Number of such pairs.
+    // Deepest path in hops from vertex 0, from 0 to the deepest vertex.
+    std::vector<int> depthPath;
+    // Heaviest path (weighted diameter): its vertices in order, and `heaviestPathWeights[i]`, the weight of
+    // the edge between `heaviestPath[i]` and `heaviestPath[i + 1]`.
+    std::vector<int> heaviestPath, heaviestPathWeights;
+    // Heaviest and lightest edges as (vertex, neighbor, weight); the first one in CSR order wins ties.
+    // The vertices are -1 if there is no edge (or, for the heaviest edge, no positive weight).
+    int maxEdgeU = -1, maxEdgeV = -1, maxEdgeWeight = 0;
+    int minEdgeU = -1, minEdgeV = -1, minEdgeWeight = INT_MAX;
+};
+
+// An undirected weighted edge, as passed to `Graph::add_edges`.
+struct WeightedEdge {
+    int u;
+    int v;
+    int weight;
+};
+
+/*
+ * The MST and its analytics as plain numbers, as returned by `Graph::analyzeMST()`.
+ * Nothing here is formatted: the text report is an optional, separate step (`Graph::formatAnalysis` and the
+ * `Graph::format...` helpers), so binary clients and benchmarks read the fields directly.
+ */
+struct MSTResult {
+    int vertices = 0;
+    std::vector<WeightedEdge> edges;    // The MST edges with u < v, in CSR order.
+    double totalWeight = 0;
+    double averageDistance = 0;         // Over all pairs of connected vertices (0 without any pair).
+    std::vector<int> longestPath;       // Deepest path in hops from vertex 0 (see `TreeSummary::depthPath`).
+    // Heaviest path: its vertices in order, and the weight of the edge after each vertex but the last.
+    std::vector<int> heaviestPath, heaviestPathWeights;
+    // Heaviest and lightest edges, with the conventions of `TreeSummary` when there are none.
+    WeightedEdge heaviestEdge{-1, -1, 0}, lightestEdge{-1, -1, INT_MAX};
+};
+
+/*
+ * Destination of a streamed report (`Graph::writeGraph`, `writeMST`, `writeAnalysis`). It receives the text in
+ * order, a piece at a time, so that a listing of millions of edges never has to exist as one string.
+ */
+class TextSink {
+public:
+    virtual ~TextSink() = default;
+    virtual void write(const char* data, size_t size) = 0;
+    void write(const std::string& text) { write(text.data(), text.size()); }
+};
+
+// Appends a streamed report to a string.
+class StringSink : public TextSink {
+public:
+    explicit StringSink(std::string& out) : out(out) {}
+    using TextSink::write;
+    void write(const char* data, size_t size) override { out.append(data, size); }
+
+private:
+    std::string& out;
+};
 
 class Graph {
 public:
+    std::unique_ptr<Graph> mst;
+
+private:
     // Vector where each index represents a vertex, and each element is a list of pairs representing edges.
+    // Read through `getAdjList()`; only the edge mutators write it, so that the version, the edge index and the
+    // CSR snapshot follow every change.
     std::vector<std::list<std::pair<int, int>>> adjList;
-
+    // Set through `setAlgorithm()`, which marks the MST dirty when the choice changes.
     std::string _algorithmChoice = "prim";
-    std::unique_ptr<Graph> mst;
+
+    // Hash index from each edge to its two entries in `adjList`: lets the edge mutators and lookups skip the list scans.
+    EdgeIndex _edgeIndex;
+    void rebuildEdgeIndex();
+    bool insertEdge(int u, int v, int weight, int& oldWeight);
+
+    // Contiguous snapshot of `adjList`, rebuilt lazily by `freeze()` after the graph has been modified.
+    CSRGraph _csr;
+    bool _csrFrozen = false;
+
+    // Version stamp of the graph contents. Every edge mutation and algorithm change draws a new stamp from a
+    // process-wide counter, so a stamp identifies one state of one graph (copies share the stamp of their source).
+    uint64_t _version;
+    // Graph version and algorithm the current `mst` was computed for.
+    uint64_t _solvedVersion = 0;
+    std::string _solvedAlgorithm;
+
+    // A cached result together with the version stamp it was computed for (0 = never computed).
+    template <typename T>
+    struct Cached {
+        uint64_t stamp = 0;
+        T value{};
+    };
+    // Analytics are keyed by the version of `mst`; the full report also depends on the graph itself.
+    // The string slots hold the formatted getters, computed from `_resultMST` on demand.
+    Cached<MSTResult> _resultMST;
+    Cached<std::string> _depthPathMST, _maxWeightPathMST, _maxWeightEdgeMST, _minWeightEdgeMST;
+    Cached<std::string> _displayGraph, _displayMST, _analysis;
+    uint64_t _analysisMSTVersion = 0;
+    std::string _analysisAlgorithm;
+
+    static uint64_t nextVersion();
+    void touch();
+    template <typename T>
+    const T& remember(Cached<T>& slot, uint64_t stamp, T value);
+
+    // Dynamic MST mode: the minimum spanning forest is maintained in place by the edge mutators.
+    // While the forest spans the whole graph it lives in `mst`; otherwise it is kept in `_msf`
+    // and `mst` holds an empty graph, as the solvers return for disconnected graphs.
+    bool _dynamicMST = false;
+    bool _forestReady = false;
+    int _forestEdges = 0;
+    std::unique_ptr<Graph> _msf;
+    // Scratch buffers for forest searches; `_mark[x] == _markStamp` means x was visited by the current search.
+    std::vector<int> _mark, _trail, _trailWeight, _visitOrder;
+    int _markStamp = 0;
+
+    Graph& forest();
+    void publishForest();
+    bool markForestComponent(int source, int target);
+    void forestInsert(int u, int v, int weight);
+    void forestReplaceTreeEdge(int u, int v);
+    void updateForest(int u, int v, bool hadEdge, int oldWeight, bool hasEdge, int newWeight);
+
+public:
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 //                          Functions primarily used for random Graph                                //
@@ -52,12 +267,20 @@ public:
     Graph(int vertices);
     // Copy constructor
     Graph(const Graph& other);
+    // Move constructor
+    Graph(Graph&& other) noexcept;
     // Copy assignment operator
     Graph& operator=(const Graph& other);
     // Move assignment operator
     Graph& operator=(Graph&& other) noexcept;
     // Adds an edge between vertices `u` and `v` with the specified weight.
     void add_edge(int u, int v, int weight);
+    /* Adds (or re-weights) a batch of edges in one pass, with the same semantics as calling `add_edge` on each.
+     * The graph is marked modified once, and in dynamic MST mode the forest is rebuilt by the next `Solve()`
+     * instead of being repaired after every edge. Edges with invalid vertices are skipped.
+     * Returns the number of edges applied. */
+    size_t add_edges(const WeightedEdge* edges, size_t count);
+    size_t add_edges(const std::vector<WeightedEdge>& edges);
     // Removes an edge between vertices `u` and `v`.
     void remove_edge(int u, int v);
     // Returns the total number of vertices in the graph.
@@ -70,6 +293,28 @@ public:
     bool compareGraphs(Graph& other);
     // Changes the weight of an existing undirected edge between vertices `u` and `v` to `newWeight`.
     void changeEdgeWeight(int u, int v, int newWeight);
+    // Checks in O(1) whether vertices `u` and `v` are connected by an edge.
+    bool hasEdge(int u, int v) const;
+    // Stores the weight of edge (u, v) in `weight` and returns true, or returns false if there is no such edge. O(1).
+    bool getEdgeWeight(int u, int v, int& weight) const;
+    // Selects the MST algorithm used by `Solve()`; the MST is only marked dirty if the choice actually changes.
+    void setAlgorithm(const std::string& algorithm);
+    // Returns the MST algorithm used by `Solve()`.
+    const std::string& getAlgorithm() const;
+    // Returns the version stamp of the graph, which changes whenever an edge or the algorithm choice changes.
+    uint64_t getVersion() const;
+    // Rebuilds the CSR snapshot from the adjacency list if the graph changed since the last freeze.
+    void freeze();
+    // Returns the CSR snapshot of the graph, freezing it first if needed. Solvers and analysis functions read from it.
+    const CSRGraph& getCSR();
+    /* Enables or disables the dynamic MST mode.
+     * When enabled, the first call to `Solve()` builds the MST with the selected algorithm, and from then on
+     * `add_edge`, `remove_edge` and `changeEdgeWeight` update `mst` in place:
+     *  - inserting an edge (or lowering a non-tree edge) swaps it with the heaviest edge on the tree cycle it closes;
+     *  - deleting a tree edge (or raising its weight) searches for the lightest edge reconnecting the two halves.
+     * `Solve()` only rebuilds from scratch when the algorithm choice changes. */
+    void setDynamicMST(bool enabled);
+    bool isDynamicMST() const;
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 //            Functions primarily used for MST (Minimum Spanning Tree) operations                    //
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +326,9 @@ public:
     std::string displayGraph();
     // Displays the MST structure, showing each vertex and its connected edges.
     std::string displayMST();
+    // Stream the text of `displayGraph()` / `displayMST()` to `sink` in fixed-size chunks, without caching it.
+    void writeGraph(TextSink& sink);
+    void writeMST(TextSink& sink);
     // Finds the longest path in the MST (returns a string representing the path in the format "0->9->...").
     std::string getTreeDepthPath_MST();
     // Retrieves the heaviest edge in the MST (returns a string in the format "u v w",
@@ -92,8 +340,31 @@ public:
     std::string getMinWeightEdge_MST();
     // Calculates the average distance between all pairs of vertices (Xi, Xj) in the MST.
     double getAverageDistance_MST();
+    // Sums the distances between all pairs of connected vertices of a tree (or forest) in linear time,
+    // using subtree sizes instead of an all-pairs shortest path computation. `pairCount` receives the number of pairs.
+    static double sumTreeDistances(const CSRGraph& tree, long long& pairCount);
+    /* Computes in two iterative depth-first passes every tree statistic of the MST report (see `TreeSummary`):
+     *  1. from each root in turn: total weight, lightest and heaviest edges, subtree sizes (hence the sum of
+     *     all pairwise distances), the deepest vertex in hops from 0 and the farthest one by weight;
+     *  2. from that farthest vertex: the heaviest path, by the double-sweep property of trees. */
+    static TreeSummary summarizeTree(const CSRGraph& tree);
+    // MST size (in vertices) from which `analyzeMST` and `Analysis` fan their work out onto the thread pool.
+    static constexpr int PARALLEL_ANALYSIS_MIN_VERTICES = 2048;
+    /* Computes the MST result (after `Solve()`), cached until the MST changes; the getters above format it.
+     * The metrics come from one `summarizeTree` run; on large MSTs it runs as a task on `ThreadPool::shared()`
+     * while the calling thread lists the edges. `parallel = false` forces a sequential run. */
+    const MSTResult& analyzeMST(bool parallel = true);
+    // Formatting of the MST result, in the formats of the corresponding getters.
+    static std::string formatEdge(const WeightedEdge& edge);
+    static std::string formatLongestPath(const MSTResult& result);
+    static std::string formatHeaviestPath(const MSTResult& result);
+    // Formats the "MST Analysis" section of the report from the result of an MST built with `algorithm`.
+    static std::string formatAnalysis(const std::string& algorithm, const MSTResult& result);
     // Performs a comprehensive analysis of the graph and its MST and stores the results
     std::string Analysis();
+    /* Streams the `Analysis()` report to `sink` without building (or caching) its listings: on large MSTs the
+     * MST result is computed on the thread pool while the listings are written. */
+    void writeAnalysis(TextSink& sink);
     /* The Solve method is designed to execute the primary algorithm associated with the graph.
      * Depending on the context, this method could:
      *  - Construct the Minimum Spanning Tree (MST) of the graph using the algorithm specified
@@ -105,8 +376,37 @@ public:
      * or results are computed based on the input and selected algorithm.
      *
      * The results or changes performed by this function can be accessed through other member functions
-     * such as `displayGraph`, `displayMST`, or `Analysis`*/
+     * such as `displayGraph`, `displayMST`, or `Analysis`.
+     *
+     * Solve() is lazy: the MST is only recomputed when the graph or the algorithm choice changed since the
+     * last run, and each analysis function caches its result until the MST changes.*/
     void Solve();
 
 };
+
+/*
+ * The `writeAnalysis()` report of a solved graph, written a chunk at a time: each `next()` call continues where
+ * the previous one stopped, so that a server produces the report only as fast as its client reads it. The graph
+ * and its MST must not change until `next()` has returned false.
+ */
+class ReportCursor {
+public:
+    // Where a listing resumes: its part (title, vertex list, edge lines), the next vertex and the next CSR edge.
+    struct Position {
+        int part = 0;
+        int vertex = 0;
+        int edge = 0;
+    };
+
+    explicit ReportCursor(Graph& graph);
+    // Writes the next whole lines of the report, about `budget` bytes, to `sink`; returns false once it is complete.
+    bool next(TextSink& sink, size_t budget);
+
+private:
+    enum class Section { Start, GraphListing, MSTListing, Analysis, Done };
+
+    Graph& graph;
+    Section section = Section::Start;
+    Position position;
+};
 #endif // GRAPH_HPP
\ No newline at end of file
@@ -1,146 +1,242 @@
 #include "MSTFactory.hpp"
 #include "Graph.hpp"
+#include "../Network/ThreadPool.hpp"
 #include <algorithm>
 #include <vector>
 #include <tuple>
-#include <queue>
 #include <limits>
+#include <cstdint>
+#include <functional>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Runs body(slice, lo, hi) over `threads` contiguous slices of [0, count): on the calling thread when
+// there is a single slice, otherwise as tasks forked into the shared work-stealing pool.
+static void parallelFor(int threads, int count, const std::function<void(int, int, int)>& body) {
+    ThreadPool::shared().parallelFor(threads, count, body);
+}
+
+std::unique_ptr<MSTFactory> MSTFactory::create(const std::string& name, int numThreads) {
+    if (name == "prim") return std::make_unique<PrimSolver>();
+    if (name == "kruskal") return std::make_unique<KruskalSolver>();
+    if (name == "boruvka") return std::make_unique<BoruvkaSolver>(numThreads);
+    if (name == "filter_kruskal") return std::make_unique<FilterKruskalSolver>(numThreads);
+    if (name == "tarjan") return std::make_unique<TarjanSolver>();
+    if (name == "integer_mst") return std::make_unique<IntegerMSTSolver>();
+    if (name == "auto") return std::make_unique<AutoSolver>(numThreads);
+    return nullptr;
+}
 
 // Prim's Algorithm Solver
 Graph PrimSolver::solveMST(Graph& graph) {
-    int V = graph.getNumVertices();
+    const CSRGraph& csr = graph.getCSR();
+    int V = csr.numVertices();
     Graph mst(V);
 
-    std::vector<bool> inMST(V, false);
     std::vector<int> key(V, std::numeric_limits<int>::max());
     std::vector<int> parent(V, -1);
+    if (V > 0) {
+        long long E = csr.numEdges();
+        if (E * DENSE_RATIO_DIVISOR >= static_cast<long long>(V) * V) solveDense(csr, key, parent);
+        else solveSparse(csr, key, parent);
+    }
 
-    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> pq;
+    int edgeCount = 0;
+    for (int v = 1; v < V; ++v) {
+        if (parent[v] != -1) {
+            mst.add_edge(parent[v], v, key[v]);
+            edgeCount++;
+        }
+    }
 
-    key[0] = 0;
-    pq.push({0, 0});
+    if (edgeCount < V - 1) {
+        return Graph(0); // No MST found
+    }
 
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        pq.pop();
+    return mst;
+}
+
+// O(E log V) Prim with decrease-key on an indexed d-ary heap.
+void PrimSolver::solveSparse(const CSRGraph& csr, std::vector<int>& key, std::vector<int>& parent) {
+    int V = csr.numVertices();
+    std::vector<bool> inMST(V, false);
+    IndexedDaryHeap heap(V);
 
-        if (inMST[u]) continue;
+    key[0] = 0;
+    heap.insert(0, 0);
 
+    while (!heap.empty()) {
+        int u = heap.extractMin();
         inMST[u] = true;
 
-        for (const auto& [v, weight] : graph.getAdjList()[u]) {
+        for (int e = csr.begin(u); e < csr.end(u); ++e) {
+            int v = csr.targets[e];
+            int weight = csr.weights[e];
             if (!inMST[v] && weight < key[v]) {
                 key[v] = weight;
-                pq.push({key[v], v});
                 parent[v] = u;
+                if (heap.contains(v)) heap.decreaseKey(v, weight);
+                else heap.insert(v, weight);
             }
         }
     }
+}
 
-    int edgeCount = 0;
-    for (int v = 1; v < V; ++v) {
-        if (parent[v] != -1) {
-            mst.add_edge(parent[v], v, key[v]);
-            edgeCount++;
+// O(V^2 + E) Prim: scan the key array for the closest vertex instead of keeping a heap.
+void PrimSolver::solveDense(const CSRGraph& csr, std::vector<int>& key, std::vector<int>& parent) {
+    int V = csr.numVertices();
+    std::vector<bool> inMST(V, false);
+
+    key[0] = 0;
+    for (int step = 0; step < V; ++step) {
+        int u = -1;
+        for (int v = 0; v < V; ++v) {
+            if (!inMST[v] && key[v] != std::numeric_limits<int>::max() && (u == -1 || key[v] < key[u])) u = v;
+        }
+        if (u == -1) break; // The rest is unreachable.
+        inMST[u] = true;
+
+        for (int e = csr.begin(u); e < csr.end(u); ++e) {
+            int v = csr.targets[e];
+            int weight = csr.weights[e];
+            if (!inMST[v] && weight < key[v]) {
+                key[v] = weight;
+                parent[v] = u;
+            }
         }
     }
+}
 
-    if (edgeCount < V - 1) {
+// Kruskal's Algorithm Solver
+Graph KruskalSolver::solveMST(Graph& graph) {
+    Graph mst = solveForest(graph);
+
+    if (mst.getCSR().numEdges() < graph.getNumVertices() - 1) {
         return Graph(0); // No MST found
     }
 
     return mst;
 }
 
-// Kruskal's Algorithm Solver
-Graph KruskalSolver::solveMST(Graph& graph) {
-    Graph mst(graph.getNumVertices());
+// Minimum spanning forest with Kruskal's algorithm (one tree per connected component)
+Graph KruskalSolver::solveForest(Graph& graph) {
+    const CSRGraph& csr = graph.getCSR();
+    Graph forest(csr.numVertices());
     std::vector<std::tuple<int, int, int>> edges;
+    edges.reserve(csr.numEdges());
 
-    for (int u = 0; u < graph.getNumVertices(); ++u) {
-        for (const auto& [v, weight] : graph.getAdjList()[u]) {
-            if (u < v) {
-                edges.emplace_back(weight, u, v);
+    for (int u = 0; u < csr.numVertices(); ++u) {
+        for (int e = csr.begin(u); e < csr.end(u); ++e) {
+            if (u < csr.targets[e]) {
+                edges.emplace_back(csr.weights[e], u, csr.targets[e]);
             }
         }
     }
 
     std::sort(edges.begin(), edges.end());
-    UnionFind uf(graph.getNumVertices());
+    UnionFind uf(csr.numVertices());
 
-    int edgeCount = 0;
     for (const auto& [weight, u, v] : edges) {
         if (uf.unionSets(u, v)) {
-            mst.add_edge(u, v, weight);
-            edgeCount++;
+            forest.add_edge(u, v, weight);
         }
     }
 
-    if (edgeCount < graph.getNumVertices() - 1) {
-        return Graph(0); // No MST found
-    }
-
-    return mst;
+    return forest;
 }
 
 // Borůvka's Algorithm Solver
+BoruvkaSolver::BoruvkaSolver(int numThreads) : numThreads(std::max(1, numThreads)) {}
+
 Graph BoruvkaSolver::solveMST(Graph& graph) {
-    int V = graph.getNumVertices();
+    const CSRGraph& csr = graph.getCSR();
+    int V = csr.numVertices();
     Graph mst(V);
 
+    // Cheapest edge leaving a component, ordered by (weight, a, b) with a < b so that ties are broken the same
+    // way from both sides and equal weights cannot close a cycle.
+    struct Candidate {
+        int weight = 0, a = -1, b = -1;
+        bool valid() const { return a != -1; }
+        bool operator<(const Candidate& other) const {
+            return std::tie(weight, a, b) < std::tie(other.weight, other.a, other.b);
+        }
+    };
+
+    // `component[v]` is the compact label (0..numComponents-1) of the component containing v.
     std::vector<int> component(V);
     for (int i = 0; i < V; ++i) {
         component[i] = i;
     }
-
     int numComponents = V;
-    UnionFind uf(V);
+
+    // Split the vertices into contiguous ranges, one per thread (small graphs stay on the calling thread).
+    int threads = std::max(1, std::min(numThreads, V / MIN_VERTICES_PER_THREAD));
+    std::vector<std::vector<Candidate>> cheapest(threads);
 
     int edgeCount = 0;
 
     // Loop until there is only one component or no further progress can be made
     while (numComponents > 1) {
-        std::vector<std::pair<int, std::pair<int, int>>> cheapest(V, {-1, {-1, -1}});
-
-        // Find the cheapest edges connecting each component
-        for (int u = 0; u < V; ++u) {
-            for (const auto& [v, weight] : graph.getAdjList()[u]) {
-                int compU = uf.find(u);
-                int compV = uf.find(v);
-
-                if (compU != compV) {
-                    if (cheapest[compU].first == -1 || cheapest[compU].first > weight) {
-                        cheapest[compU] = {weight, {u, v}};
+        // Find the cheapest edge leaving each component, in thread-local arrays indexed by component.
+        parallelFor(threads, V, [&](int t, int lo, int hi) {
+            auto& local = cheapest[t];
+            local.assign(numComponents, Candidate{});
+            for (int u = lo; u < hi; ++u) {
+                int compU = component[u];
+                for (int e = csr.begin(u); e < csr.end(u); ++e) {
+                    int v = csr.targets[e];
+                    if (compU == component[v]) continue;
+                    Candidate candidate{csr.weights[e], std::min(u, v), std::max(u, v)};
+                    if (!local[compU].valid() || candidate < local[compU]) {
+                        local[compU] = candidate;
                     }
-                    if (cheapest[compV].first == -1 || cheapest[compV].first > weight) {
-                        cheapest[compV] = {weight, {v, u}};
+                }
+            }
+        });
+
+        // Reduce the thread-local arrays into the first one.
+        parallelFor(threads, numComponents, [&](int, int lo, int hi) {
+            for (int c = lo; c < hi; ++c) {
+                for (int t = 1; t < threads; ++t) {
+                    const Candidate& candidate = cheapest[t][c];
+                    if (candidate.valid() && (!cheapest[0][c].valid() || candidate < cheapest[0][c])) {
+                        cheapest[0][c] = candidate;
                     }
                 }
             }
-        }
-
-        bool merged = false;  // Track if any components are merged in this iteration
+        });
 
         // Add the cheapest edges to the MST
-        for (int i = 0; i < V; ++i) {
-            if (cheapest[i].first != -1) {
-                int u = cheapest[i].second.first;
-                int v = cheapest[i].second.second;
-                int weight = cheapest[i].first;
-
-                if (uf.unionSets(u, v)) {
-                    mst.add_edge(u, v, weight);
-                    --numComponents;
-                    edgeCount++;
-                    merged = true;  // A merge happened, so progress was made
-                }
+        UnionFind uf(numComponents);
+        bool merged = false;  // Track if any components are merged in this iteration
+        for (const Candidate& candidate : cheapest[0]) {
+            if (candidate.valid() && uf.unionSets(component[candidate.a], component[candidate.b])) {
+                mst.add_edge(candidate.a, candidate.b, candidate.weight);
+                edgeCount++;
+                merged = true;  // A merge happened, so progress was made
             }
         }
 
         // If no components were merged and we still have more than one component, stop
-        if (!merged && numComponents > 1) {
+        if (!merged) {
             return Graph(0);  // No MST found
         }
+
+        // Contract: relabel the merged components with compact ids for the next round.
+        std::vector<int> relabel(numComponents, -1);
+        int next = 0;
+        for (int c = 0; c < numComponents; ++c) {
+            int root = uf.find(c);
+            if (relabel[root] == -1) relabel[root] = next++;
+            relabel[c] = relabel[root];
+        }
+        numComponents = next;
+        parallelFor(threads, V, [&](int, int lo, int hi) {
+            for (int v = lo; v < hi; ++v) component[v] = relabel[component[v]];
+        });
     }
 
     // If the number of edges is less than V-1, return an empty graph (no MST)
@@ -151,72 +247,356 @@ Graph BoruvkaSolver::solveMST(Graph& graph) {
     return mst;
 }
 
-// Tarjan's Algorithm Solver
+// Filter-Kruskal Solver
+FilterKruskalSolver::FilterKruskalSolver(int numThreads) : numThreads(std::max(1, numThreads)) {}
+
+Graph FilterKruskalSolver::solveMST(Graph& graph) {
+    const CSRGraph& csr = graph.getCSR();
+    int V = csr.numVertices();
+    Graph mst(V);
+
+    std::vector<Edge> edges;
+    edges.reserve(csr.numEdges());
+    for (int u = 0; u < V; ++u) {
+        for (int e = csr.begin(u); e < csr.end(u); ++e) {
+            if (u < csr.targets[e]) {
+                edges.push_back({csr.weights[e], u, csr.targets[e]});
+            }
+        }
+    }
+
+    UnionFind uf(V);
+    std::vector<Edge> buffer(edges.size());
+    int edgeCount = 0;
+    filterKruskal(edges.data(), edges.data() + edges.size(), buffer.data(), uf, mst, edgeCount, V - 1);
+
+    if (edgeCount < V - 1) {
+        return Graph(0); // No MST found
+    }
+
+    return mst;
+}
+
+// Stable parallel split of [first, last): the elements satisfying `keep` are moved to the front, in order, and the
+// others are written after them when `keepRest` is true (or discarded). Returns the number of kept elements.
+size_t FilterKruskalSolver::split(Edge* first, Edge* last, Edge* buffer, bool keepRest,
+                                  const std::function<bool(const Edge&)>& keep) const {
+    int size = static_cast<int>(last - first);
+    int threads = size >= PARALLEL_THRESHOLD ? numThreads : 1;
+    std::vector<size_t> keptPerThread(threads, 0), restPerThread(threads, 0);
+
+    // Count, then scatter each slice to its offset in `buffer`.
+    parallelFor(threads, size, [&](int t, int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            if (keep(first[i])) ++keptPerThread[t];
+            else ++restPerThread[t];
+        }
+    });
+    size_t totalKept = 0;
+    for (size_t count : keptPerThread) totalKept += count;
+    std::vector<size_t> keptOffset(threads, 0), restOffset(threads, totalKept);
+    for (int t = 1; t < threads; ++t) {
+        keptOffset[t] = keptOffset[t - 1] + keptPerThread[t - 1];
+        restOffset[t] = restOffset[t - 1] + restPerThread[t - 1];
+    }
+    parallelFor(threads, size, [&](int t, int lo, int hi) {
+        size_t kept = keptOffset[t], rest = restOffset[t];
+        for (int i = lo; i < hi; ++i) {
+            if (keep(first[i])) buffer[kept++] = first[i];
+            else if (keepRest) buffer[rest++] = first[i];
+        }
+    });
+
+    size_t total = keepRest ? static_cast<size_t>(size) : totalKept;
+    parallelFor(threads, static_cast<int>(total), [&](int, int lo, int hi) {
+        std::copy(buffer + lo, buffer + hi, first + lo);
+    });
+    return totalKept;
+}
+
+// Plain Kruskal on [first, last): sort by (weight, u, v) and take edges until the forest is complete.
+void FilterKruskalSolver::kruskal(Edge* first, Edge* last, UnionFind& uf, Graph& mst, int& edgeCount, int target) const {
+    std::sort(first, last, [](const Edge& a, const Edge& b) {
+        return std::tie(a.weight, a.u, a.v) < std::tie(b.weight, b.u, b.v);
+    });
+    for (Edge* edge = first; edge != last && edgeCount < target; ++edge) {
+        if (uf.unionSets(edge->u, edge->v)) {
+            mst.add_edge(edge->u, edge->v, edge->weight);
+            ++edgeCount;
+        }
+    }
+}
+
+// Kruskal on [first, last): small ranges are sorted, larger ones are partitioned around a pivot weight. The light
+// half is processed first; the heavy half is then filtered of edges that already lie inside one component.
+void FilterKruskalSolver::filterKruskal(Edge* first, Edge* last, Edge* buffer, UnionFind& uf, Graph& mst,
+                                        int& edgeCount, int target) const {
+    if (edgeCount >= target || first == last) return;
+
+    size_t size = static_cast<size_t>(last - first);
+    if (size <= BASE_CASE_SIZE) {
+        kruskal(first, last, uf, mst, edgeCount, target);
+        return;
+    }
+
+    // Median of three samples as pivot.
+    int samples[3] = {first[0].weight, first[size / 2].weight, last[-1].weight};
+    std::sort(samples, samples + 3);
+    int pivot = samples[1];
+
+    size_t light = split(first, last, buffer, true, [pivot](const Edge& edge) { return edge.weight <= pivot; });
+    if (light == size) {
+        // Everything is <= pivot: split strictly below the pivot instead, or sort if all weights are equal.
+        light = split(first, last, buffer, true, [pivot](const Edge& edge) { return edge.weight < pivot; });
+        if (light == 0) {
+            kruskal(first, last, uf, mst, edgeCount, target);
+            return;
+        }
+    }
+
+    filterKruskal(first, first + light, buffer, uf, mst, edgeCount, target);
+    if (edgeCount >= target) return;
+
+    // Filter: only heavy edges between different components can still join the MST. The lookups do not
+    // compress paths, so they are safe to run concurrently.
+    Edge* heavy = first + light;
+    size_t remaining = split(heavy, last, buffer, false, [&uf](const Edge& edge) { return uf.root(edge.u) != uf.root(edge.v); });
+    filterKruskal(heavy, heavy + remaining, buffer, uf, mst, edgeCount, target);
+}
+
+// Tarjan's Algorithm Solver (Fredman-Tarjan)
 Graph TarjanSolver::solveMST(Graph& graph) {
-    Graph mst(graph.getNumVertices());
-    std::vector<std::tuple<int, int, int>> edges;
+    const CSRGraph& csr = graph.getCSR();
+    int V = csr.numVertices();
+    Graph mst(V);
 
-    for (int u = 0; u < graph.getNumVertices(); ++u) {
-        for (const auto& [v, weight] : graph.getAdjList()[u]) {
+    // Original undirected edges, indexed by id. The contracted graphs refer to them by id.
+    std::vector<int> edgeU, edgeV, edgeW;
+    edgeU.reserve(csr.numEdges());
+    edgeV.reserve(csr.numEdges());
+    edgeW.reserve(csr.numEdges());
+
+    // Current (contracted) graph in CSR form: every half-edge also carries the id of its original edge.
+    std::vector<int> offsets(V + 1, 0), targets(csr.targets.size()), ids(csr.targets.size());
+    for (int u = 0; u < V; ++u) {
+        offsets[u + 1] = csr.end(u);
+        for (int e = csr.begin(u); e < csr.end(u); ++e) {
+            int v = csr.targets[e];
             if (u < v) {
-                edges.emplace_back(weight, u, v);
+                edgeU.push_back(u);
+                edgeV.push_back(v);
+                edgeW.push_back(csr.weights[e]);
             }
         }
     }
+    // Assign ids to both half-edges of every original edge (self-loops are dropped).
+    {
+        int id = 0, slot = 0;
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (int u = 0; u < V; ++u) {
+            for (int e = csr.begin(u); e < csr.end(u); ++e) {
+                int v = csr.targets[e];
+                if (u < v) {
+                    targets[cursor[u]] = v;
+                    ids[cursor[u]++] = id;
+                    targets[cursor[v]] = u;
+                    ids[cursor[v]++] = id;
+                    ++id;
+                }
+            }
+        }
+        // Compact away the slots left empty by self-loops.
+        for (int u = 0; u < V; ++u) {
+            int start = offsets[u];
+            offsets[u] = slot;
+            for (int e = start; e < cursor[u]; ++e) {
+                targets[slot] = targets[e];
+                ids[slot++] = ids[e];
+            }
+        }
+        offsets[V] = slot;
+        targets.resize(slot);
+        ids.resize(slot);
+    }
 
-    std::sort(edges.begin(), edges.end());
-    UnionFind uf(graph.getNumVertices());
+    // `label[x]` maps an original vertex to its current super-vertex.
+    std::vector<int> label(V);
+    for (int i = 0; i < V; ++i) label[i] = i;
 
+    int t = V;                     // Number of super-vertices in the current graph.
     int edgeCount = 0;
-    for (const auto& [weight, u, v] : edges) {
-        if (uf.unionSets(u, v)) {
-            mst.add_edge(u, v, weight);
-            edgeCount++;
+    FibonacciHeap heap(V);
+    std::vector<int> tree(V), connectingEdge(V);
+    std::vector<int> chosen;       // Original ids of the MST edges selected during the current pass.
+
+    auto lighter = [&](int a, int b) { return edgeW[a] < edgeW[b] || (edgeW[a] == edgeW[b] && a < b); };
+
+    while (offsets[t] > 0) {
+        // Heap size bound of this pass: k = 2^(2m/t). The denser the graph, the longer each tree may grow.
+        long long twoM = offsets[t];
+        long long exponent = (twoM + t - 1) / t;
+        int k = exponent >= 30 ? std::numeric_limits<int>::max() : (1 << exponent);
+
+        std::fill(tree.begin(), tree.begin() + t, -1);
+        chosen.clear();
+
+        // Grow a tree from every super-vertex not reached yet, with Prim's algorithm on a Fibonacci heap.
+        // Growth stops when the heap exceeds k, or when the tree reaches another tree (the two get joined).
+        for (int root = 0; root < t; ++root) {
+            if (tree[root] != -1) continue;
+            heap.clear();
+            int x = root;
+            while (true) {
+                tree[x] = root;
+                for (int e = offsets[x]; e < offsets[x + 1]; ++e) {
+                    int y = targets[e];
+                    if (tree[y] == root) continue;
+                    if (!heap.contains(y)) {
+                        heap.insert(y, edgeW[ids[e]]);
+                        connectingEdge[y] = ids[e];
+                    } else if (lighter(ids[e], connectingEdge[y])) {
+                        heap.decreaseKey(y, edgeW[ids[e]]);
+                        connectingEdge[y] = ids[e];
+                    }
+                }
+                if (heap.empty() || heap.size() > k) break;
+
+                x = heap.extractMin();
+                chosen.push_back(connectingEdge[x]);
+                if (tree[x] != -1) break; // Reached an earlier tree: joined through the chosen edge.
+            }
+        }
+        edgeCount += static_cast<int>(chosen.size());
+        for (int id : chosen) {
+            mst.add_edge(edgeU[id], edgeV[id], edgeW[id]);
+        }
+
+        // Contract every tree into a single super-vertex.
+        UnionFind uf(t);
+        for (int id : chosen) {
+            uf.unionSets(label[edgeU[id]], label[edgeV[id]]);
+        }
+        std::vector<int> newLabel(t, -1);
+        int newT = 0;
+        for (int x = 0; x < t; ++x) {
+            int r = uf.find(x);
+            if (newLabel[r] == -1) newLabel[r] = newT++;
+            newLabel[x] = newLabel[r];
         }
+        for (int i = 0; i < V; ++i) label[i] = newLabel[label[i]];
+
+        // Rebuild the contracted CSR: drop edges inside a super-vertex and keep only the lightest
+        // edge between two super-vertices. `bestSlot` is stamped with the source to avoid clearing it.
+        std::vector<int> newOffsets(newT + 1, 0), bucketStart(newT + 1, 0);
+        for (int x = 0; x < t; ++x) bucketStart[newLabel[x] + 1] += offsets[x + 1] - offsets[x];
+        for (int a = 0; a < newT; ++a) bucketStart[a + 1] += bucketStart[a];
+        std::vector<int> grouped(offsets[t]), groupedTargets(offsets[t]);
+        {
+            std::vector<int> cursor(bucketStart.begin(), bucketStart.end() - 1);
+            for (int x = 0; x < t; ++x) {
+                for (int e = offsets[x]; e < offsets[x + 1]; ++e) {
+                    int slot = cursor[newLabel[x]]++;
+                    grouped[slot] = ids[e];
+                    groupedTargets[slot] = newLabel[targets[e]];
+                }
+            }
+        }
+        std::vector<int> stamp(newT, -1), bestSlot(newT, -1);
+        std::vector<int> nextTargets, nextIds;
+        nextTargets.reserve(offsets[t]);
+        nextIds.reserve(offsets[t]);
+        for (int a = 0; a < newT; ++a) {
+            newOffsets[a] = static_cast<int>(nextTargets.size());
+            for (int e = bucketStart[a]; e < bucketStart[a + 1]; ++e) {
+                int b = groupedTargets[e];
+                if (b == a) continue;
+                if (stamp[b] != a) {
+                    stamp[b] = a;
+                    bestSlot[b] = static_cast<int>(nextTargets.size());
+                    nextTargets.push_back(b);
+                    nextIds.push_back(grouped[e]);
+                } else if (lighter(grouped[e], nextIds[bestSlot[b]])) {
+                    nextIds[bestSlot[b]] = grouped[e];
+                }
+            }
+        }
+        newOffsets[newT] = static_cast<int>(nextTargets.size());
+
+        offsets.swap(newOffsets);
+        targets.swap(nextTargets);
+        ids.swap(nextIds);
+        t = newT;
     }
 
-    if (edgeCount < graph.getNumVertices() - 1) {
+    if (edgeCount < V - 1) {
         return Graph(0); // No MST found
     }
 
     return mst;
 }
 
-// Integer MST Solver
+// Integer MST Solver (Kruskal over radix-sorted integer weights)
 Graph IntegerMSTSolver::solveMST(Graph& graph) {
-    int V = graph.getNumVertices();
+    const CSRGraph& csr = graph.getCSR();
+    int V = csr.numVertices();
     Graph mst(V);
 
-    std::vector<bool> inMST(V, false);
-    std::vector<int> key(V, std::numeric_limits<int>::max());
-    std::vector<int> parent(V, -1);
-
-    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pq;
-
-    key[0] = 0;
-    pq.push({0, 0});
-
-    int edgeCount = 0;
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        pq.pop();
-
-        if (inMST[u]) continue;
-        inMST[u] = true;
-
-        for (const auto& [v, weight] : graph.getAdjList()[u]) {
-            if (!inMST[v] && weight < key[v]) {
-                key[v] = weight;
-                pq.push({key[v], v});
-                parent[v] = u;
+    struct IntegerEdge {
+        uint32_t key; // weight - minWeight, so negative weights sort correctly as unsigned keys.
+        int u, v;
+    };
+    std::vector<IntegerEdge> edges;
+    edges.reserve(csr.numEdges());
+
+    int minWeight = std::numeric_limits<int>::max(), maxWeight = std::numeric_limits<int>::min();
+    for (int u = 0; u < V; ++u) {
+        for (int e = csr.begin(u); e < csr.end(u); ++e) {
+            if (u < csr.targets[e]) {
+                minWeight = std::min(minWeight, csr.weights[e]);
+                maxWeight = std::max(maxWeight, csr.weights[e]);
+                edges.push_back({0, u, csr.targets[e]});
+                edges.back().key = static_cast<uint32_t>(csr.weights[e]);
+            }
+        }
+    }
+    for (auto& edge : edges) edge.key -= static_cast<uint32_t>(minWeight);
+
+    // Number of RADIX_BITS-wide digits needed to cover the weight range.
+    uint32_t range = edges.empty() ? 0 : static_cast<uint32_t>(maxWeight) - static_cast<uint32_t>(minWeight);
+    int passes = 1;
+    while (passes * RADIX_BITS < 32 && (range >> (passes * RADIX_BITS)) != 0) ++passes;
+
+    if (passes <= MAX_RADIX_PASSES) {
+        // LSD radix sort: one stable counting-sort pass per digit (a single pass is a plain counting sort).
+        const uint32_t buckets = 1u << RADIX_BITS;
+        std::vector<IntegerEdge> buffer(edges.size());
+        std::vector<size_t> count(buckets);
+        for (int pass = 0; pass < passes; ++pass) {
+            int shift = pass * RADIX_BITS;
+            std::fill(count.begin(), count.end(), 0);
+            for (const auto& edge : edges) ++count[(edge.key >> shift) & (buckets - 1)];
+            size_t sum = 0;
+            for (auto& c : count) {
+                size_t bucketSize = c;
+                c = sum;
+                sum += bucketSize;
             }
+            for (const auto& edge : edges) buffer[count[(edge.key >> shift) & (buckets - 1)]++] = edge;
+            edges.swap(buffer);
         }
+    } else {
+        // The weight range is too wide for a few linear passes: fall back to a comparison sort.
+        std::sort(edges.begin(), edges.end(), [](const IntegerEdge& a, const IntegerEdge& b) {
+            return std::tie(a.key, a.u, a.v) < std::tie(b.key, b.u, b.v);
+        });
     }
 
-    for (int v = 1; v < V; ++v) {
-        if (parent[v] != -1) {
-            mst.add_edge(parent[v], v, key[v]);
-            edgeCount++;
+    UnionFind uf(V);
+    int edgeCount = 0;
+    for (const auto& edge : edges) {
+        if (uf.unionSets(edge.u, edge.v)) {
+            mst.add_edge(edge.u, edge.v, static_cast<int>(edge.key + static_cast<uint32_t>(minWeight)));
+            if (++edgeCount == V - 1) break;
         }
     }
 
@@ -227,6 +607,71 @@ Graph IntegerMSTSolver::solveMST(Graph& graph) {
     return mst;
 }
 
+// Auto-selection thresholds
+AlgorithmThresholds AlgorithmThresholds::load(std::istream& in) {
+    AlgorithmThresholds thresholds;
+    auto isSolver = [](const std::string& name) { return name != "auto" && MSTFactory::create(name) != nullptr; };
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key, value;
+        if (!(fields >> key >> value) || key[0] == '#') continue;
+        try {
+            if (key == "smallGraphEdges") thresholds.smallGraphEdges = std::stoi(value);
+            else if (key == "denseRatioDivisor") thresholds.denseRatioDivisor = std::max(1, std::stoi(value));
+            else if (key == "parallelMinEdges") thresholds.parallelMinEdges = std::stoi(value);
+            else if (key == "parallelAlgorithm" && isSolver(value)) thresholds.parallelAlgorithm = value;
+            else if (key == "integerMaxRange") thresholds.integerMaxRange = std::stoll(value);
+            else if (key == "defaultAlgorithm" && isSolver(value)) thresholds.defaultAlgorithm = value;
+        } catch (const std::exception&) {
+            // Keep the default for a malformed number.
+        }
+    }
+    return thresholds;
+}
+
+const AlgorithmThresholds& AlgorithmThresholds::fromEnvironment() {
+    static const AlgorithmThresholds thresholds = [] {
+        const char* path = std::getenv("MST_THRESHOLDS");
+        if (!path) return AlgorithmThresholds();
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "MST_THRESHOLDS: cannot open " << path << ", using the default thresholds" << std::endl;
+            return AlgorithmThresholds();
+        }
+        return load(file);
+    }();
+    return thresholds;
+}
+
+void AlgorithmThresholds::save(std::ostream& out) const {
+    out << "smallGraphEdges " << smallGraphEdges << "\n"
+        << "denseRatioDivisor " << denseRatioDivisor << "\n"
+        << "parallelMinEdges " << parallelMinEdges << "\n"
+        << "parallelAlgorithm " << parallelAlgorithm << "\n"
+        << "integerMaxRange " << integerMaxRange << "\n"
+        << "defaultAlgorithm " << defaultAlgorithm << "\n";
+}
+
+// Auto Solver
+AutoSolver::AutoSolver(int numThreads, const AlgorithmThresholds& thresholds)
+    : numThreads(std::max(1, numThreads)), thresholds(thresholds) {}
+
+std::string AutoSolver::choose(const CSRGraph& csr, const AlgorithmThresholds& thresholds, int numThreads) {
+    long long V = csr.numVertices();
+    long long E = csr.numEdges();
+    if (E <= thresholds.smallGraphEdges) return "prim";
+    if (E * thresholds.denseRatioDivisor >= V * V) return "prim";
+    if (numThreads > 1 && E >= thresholds.parallelMinEdges) return thresholds.parallelAlgorithm;
+
+    auto range = std::minmax_element(csr.weights.begin(), csr.weights.end());
+    if (static_cast<long long>(*range.second) - *range.first < thresholds.integerMaxRange) return "integer_mst";
+    return thresholds.defaultAlgorithm;
+}
+
+Graph AutoSolver::solveMST(Graph& graph) {
+    return MSTFactory::create(choose(graph.getCSR(), thresholds, numThreads), numThreads)->solveMST(graph);
+}
 
 // Constructor
 UnionFind::UnionFind(int n) : parent(n), rank(n, 0) {
@@ -238,6 +683,14 @@ UnionFind::UnionFind(int n) : parent(n), rank(n, 0) {
 // Destructor
 UnionFind::~UnionFind() = default;
 
+// Find without path compression: read-only, so several threads may call it while no union is running
+int UnionFind::root(int u) const {
+    while (u != parent[u]) {
+        u = parent[u];
+    }
+    return u;
+}
+
 // Find with path compression
 int UnionFind::find(int u) {
     if (u != parent[u]) {
@@ -262,4 +715,242 @@ bool UnionFind::unionSets(int u, int v) {
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+
+// Fibonacci heap over the items 0..capacity-1. Every node lives in a preallocated array and the circular
+// sibling lists are stored as indices, so no allocation happens while the heap is in use.
+FibonacciHeap::FibonacciHeap(int capacity) : nodes(capacity), minRoot(-1), count(0) {}
+
+bool FibonacciHeap::empty() const {
+    return count == 0;
+}
+
+int FibonacciHeap::size() const {
+    return count;
+}
+
+bool FibonacciHeap::contains(int item) const {
+    return nodes[item].inHeap;
+}
+
+int FibonacciHeap::keyOf(int item) const {
+    return nodes[item].key;
+}
+
+// Adds a single node to the root list (O(1)).
+void FibonacciHeap::addRoot(int x) {
+    nodes[x].parent = -1;
+    nodes[x].mark = false;
+    if (minRoot == -1) {
+        nodes[x].left = nodes[x].right = x;
+        minRoot = x;
+        return;
+    }
+    int right = nodes[minRoot].right;
+    nodes[x].left = minRoot;
+    nodes[x].right = right;
+    nodes[minRoot].right = x;
+    nodes[right].left = x;
+    if (nodes[x].key < nodes[minRoot].key) minRoot = x;
+}
+
+// Unlinks a node from its circular sibling list.
+void FibonacciHeap::unlink(int x) {
+    nodes[nodes[x].left].right = nodes[x].right;
+    nodes[nodes[x].right].left = nodes[x].left;
+    nodes[x].left = nodes[x].right = x;
+}
+
+void FibonacciHeap::insert(int item, int key) {
+    Node& node = nodes[item];
+    node.key = key;
+    node.child = -1;
+    node.degree = 0;
+    node.inHeap = true;
+    touched.push_back(item);
+    addRoot(item);
+    ++count;
+}
+
+void FibonacciHeap::decreaseKey(int item, int key) {
+    if (key >= nodes[item].key) return;
+    nodes[item].key = key;
+    int parent = nodes[item].parent;
+    if (parent != -1 && key < nodes[parent].key) {
+        cut(item, parent);
+        // Cascading cut: walk up while the ancestors had already lost a child.
+        int y = parent;
+        while (nodes[y].parent != -1) {
+            if (!nodes[y].mark) {
+                nodes[y].mark = true;
+                break;
+            }
+            int z = nodes[y].parent;
+            cut(y, z);
+            y = z;
+        }
+    }
+    if (key < nodes[minRoot].key) minRoot = item;
+}
+
+// Moves `x` from the child list of `parent` to the root list.
+void FibonacciHeap::cut(int x, int parent) {
+    if (nodes[parent].child == x) {
+        nodes[parent].child = nodes[x].right == x ? -1 : nodes[x].right;
+    }
+    unlink(x);
+    --nodes[parent].degree;
+    addRoot(x);
+}
+
+// Makes root `y` a child of root `x`.
+void FibonacciHeap::link(int y, int x) {
+    nodes[y].parent = x;
+    nodes[y].mark = false;
+    int child = nodes[x].child;
+    if (child == -1) {
+        nodes[y].left = nodes[y].right = y;
+        nodes[x].child = y;
+    } else {
+        int right = nodes[child].right;
+        nodes[y].left = child;
+        nodes[y].right = right;
+        nodes[child].right = y;
+        nodes[right].left = y;
+    }
+    ++nodes[x].degree;
+}
+
+int FibonacciHeap::extractMin() {
+    int z = minRoot;
+
+    // Collect the remaining roots and the children of the minimum; they are consolidated below.
+    roots.clear();
+    for (int r = nodes[z].right; r != z; r = nodes[r].right) roots.push_back(r);
+    int child = nodes[z].child;
+    if (child != -1) {
+        int c = child;
+        do {
+            roots.push_back(c);
+            c = nodes[c].right;
+        } while (c != child);
+    }
+    nodes[z].inHeap = false;
+    --count;
+
+    // Consolidate: link roots of equal degree until all degrees are distinct.
+    byDegree.assign(64, -1);
+    for (int w : roots) {
+        int x = w;
+        nodes[x].parent = -1;
+        int d = nodes[x].degree;
+        while (byDegree[d] != -1) {
+            int y = byDegree[d];
+            if (nodes[y].key < nodes[x].key) std::swap(x, y);
+            link(y, x);
+            byDegree[d] = -1;
+            ++d;
+        }
+        byDegree[d] = x;
+    }
+
+    // Rebuild the root list from the consolidated trees.
+    minRoot = -1;
+    for (int x : byDegree) {
+        if (x != -1) addRoot(x);
+    }
+    return z;
+}
+
+// Resets the heap in time proportional to the number of items inserted since the last clear.
+void FibonacciHeap::clear() {
+    for (int item : touched) nodes[item].inHeap = false;
+    touched.clear();
+    minRoot = -1;
+    count = 0;
+}
+
+// Indexed d-ary heap
+IndexedDaryHeap::IndexedDaryHeap(int capacity) : position(capacity, -1), keys(capacity, 0) {
+    heap.reserve(capacity);
+}
+
+bool IndexedDaryHeap::empty() const {
+    return heap.empty();
+}
+
+int IndexedDaryHeap::size() const {
+    return static_cast<int>(heap.size());
+}
+
+bool IndexedDaryHeap::contains(int item) const {
+    return position[item] != -1;
+}
+
+int IndexedDaryHeap::keyOf(int item) const {
+    return keys[item];
+}
+
+void IndexedDaryHeap::insert(int item, int key) {
+    keys[item] = key;
+    heap.push_back(item);
+    position[item] = static_cast<int>(heap.size()) - 1;
+    siftUp(position[item]);
+}
+
+void IndexedDaryHeap::decreaseKey(int item, int key) {
+    if (key >= keys[item]) return;
+    keys[item] = key;
+    siftUp(position[item]);
+}
+
+int IndexedDaryHeap::extractMin() {
+    int top = heap.front();
+    int last = heap.back();
+    heap.pop_back();
+    position[top] = -1;
+    if (!heap.empty()) {
+        place(0, last);
+        siftDown(0);
+    }
+    return top;
+}
+
+bool IndexedDaryHeap::less(int a, int b) const {
+    return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+}
+
+void IndexedDaryHeap::place(int index, int item) {
+    heap[index] = item;
+    position[item] = index;
+}
+
+void IndexedDaryHeap::siftUp(int index) {
+    int item = heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / ARITY;
+        if (!less(item, heap[parent])) break;
+        place(index, heap[parent]);
+        index = parent;
+    }
+    place(index, item);
+}
+
+void IndexedDaryHeap::siftDown(int index) {
+    int item = heap[index];
+    int n = static_cast<int>(heap.size());
+    while (true) {
+        int first = index * ARITY + 1;
+        if (first >= n) break;
+        int best = first;
+        int last = std::min(first + ARITY, n);
+        for (int child = first + 1; child < last; ++child) {
+            if (less(heap[child], heap[best])) best = child;
+        }
+        if (!less(heap[best], item)) break;
+        place(index, heap[best]);
+        index = best;
+    }
+    place(index, item);
+}
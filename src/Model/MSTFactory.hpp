@@ -2,7 +2,13 @@
 #define MSTFACTORY_HPP
 
 class Graph;
+struct CSRGraph;
+class UnionFind;
 #include <vector>
+#include <functional>
+#include <memory>
+#include <string>
+#include <iosfwd>
 
 
 class MSTFactory {
@@ -13,6 +19,11 @@ public:
      * Pure virtual function to solve the MST problem. This method must be implemented by all derived classes.
      */
     virtual Graph solveMST(Graph& graph) = 0;
+    /*
+     * Builds the solver registered under `name` (the names accepted by the `algo` command), or returns nullptr
+     * for an unknown name. `numThreads` is passed to the solvers that can use several threads.
+     */
+    static std::unique_ptr<MSTFactory> create(const std::string& name, int numThreads = 1);
 };
 
 /*
@@ -20,10 +31,17 @@ public:
  * A class that implements Prim's algorithm for computing the Minimum Spanning Tree (MST).
  * Prim's algorithm builds the MST by starting from an arbitrary vertex and repeatedly adding the smallest edge
  * that connects a vertex in the MST to a vertex outside the MST.
+ * Sparse graphs use an indexed 4-ary heap with decrease-key, so the heap never holds more than V entries.
+ * Dense graphs (E/V >= V/DENSE_RATIO_DIVISOR) use the O(V^2) array version, which needs no heap at all.
  */
 class PrimSolver : public MSTFactory {
 public:
+    static constexpr int DENSE_RATIO_DIVISOR = 8;
     Graph solveMST(Graph& graph) override;
+
+private:
+    static void solveSparse(const CSRGraph& csr, std::vector<int>& key, std::vector<int>& parent);
+    static void solveDense(const CSRGraph& csr, std::vector<int>& key, std::vector<int>& parent);
 };
 
 /*
@@ -35,6 +53,8 @@ public:
 class KruskalSolver : public MSTFactory {
 public:
     Graph solveMST(Graph& graph) override;
+    // Computes a minimum spanning forest: unlike solveMST, a disconnected graph yields one tree per component.
+    static Graph solveForest(Graph& graph);
 };
 
 /*
@@ -42,17 +62,54 @@ public:
  * A class that implements Borůvka's algorithm for computing the Minimum Spanning Tree (MST).
  * Borůvka's algorithm is highly parallelizable and works by repeatedly merging connected components using the
  * smallest edge from each component, until only one component (the MST) remains.
+ * With several threads, each round splits the vertices across the threads, which record the cheapest edge of every
+ * component in thread-local arrays; the arrays are then reduced, and the components contracted for the next round.
  */
 class BoruvkaSolver : public MSTFactory {
 public:
+    // Below this many vertices per thread, splitting a round costs more than it saves.
+    static constexpr int MIN_VERTICES_PER_THREAD = 4096;
+    explicit BoruvkaSolver(int numThreads = 1);
+    Graph solveMST(Graph& graph) override;
+
+private:
+    int numThreads;
+};
+
+/*
+ * FilterKruskalSolver:
+ * A class that implements the Filter-Kruskal variant of Kruskal's algorithm.
+ * Instead of sorting every edge, it partitions the edges around a pivot weight and recurses on the light side first.
+ * Before the heavy side is processed, the edges whose endpoints are already in the same component are filtered out,
+ * so most heavy edges are never sorted. On large ranges, the partition and filter steps run on several threads.
+ */
+class FilterKruskalSolver : public MSTFactory {
+public:
+    // Ranges up to this size are sorted directly.
+    static constexpr size_t BASE_CASE_SIZE = 1024;
+    // Ranges below this size are partitioned/filtered on the calling thread.
+    static constexpr int PARALLEL_THRESHOLD = 1 << 16;
+    explicit FilterKruskalSolver(int numThreads = 1);
     Graph solveMST(Graph& graph) override;
+
+private:
+    struct Edge {
+        int weight, u, v;
+    };
+    int numThreads;
+
+    size_t split(Edge* first, Edge* last, Edge* buffer, bool keepRest, const std::function<bool(const Edge&)>& keep) const;
+    void kruskal(Edge* first, Edge* last, UnionFind& uf, Graph& mst, int& edgeCount, int target) const;
+    void filterKruskal(Edge* first, Edge* last, Edge* buffer, UnionFind& uf, Graph& mst, int& edgeCount, int target) const;
 };
 
 /*
  * TarjanSolver:
- * A class that implements Tarjan's algorithm for computing the Minimum Spanning Tree (MST).
- * Tarjan's algorithm is often used in dynamic or offline MST problems and is less commonly applied in basic MST problems.
- * This solver provides a solution for more advanced graph scenarios.
+ * A class that implements the Fredman-Tarjan algorithm for computing the Minimum Spanning Tree (MST).
+ * The algorithm runs in passes. Each pass grows Prim trees on a Fibonacci heap from every vertex not reached yet,
+ * stopping a tree as soon as its heap holds more than k = 2^(2m/t) vertices (t = current number of vertices) or it
+ * reaches another tree. The trees are then contracted into single vertices for the next pass. Decrease-key is O(1)
+ * amortized, so the total cost is O(m log* n): it beats Kruskal's O(m log m) sort on dense graphs.
  */
 class TarjanSolver : public MSTFactory {
 public:
@@ -62,11 +119,58 @@ public:
 /*
  * IntegerMSTSolver:
  * A class that implements a specialized MST algorithm for graphs with integer edge weights.
- * This solver can take advantage of integer-specific optimizations to compute the MST efficiently.
+ * It runs Kruskal's algorithm, but sorts the edges with an LSD radix sort on (weight - minWeight) instead of a
+ * comparison sort: each pass is a stable counting sort over RADIX_BITS bits, so sorting costs O(passes * E).
+ * When the weight range needs more than MAX_RADIX_PASSES digits, it falls back to a comparison sort.
  */
 class IntegerMSTSolver : public MSTFactory {
 public:
+    static constexpr int RADIX_BITS = 11;
+    static constexpr int MAX_RADIX_PASSES = 2;
+    Graph solveMST(Graph& graph) override;
+};
+
+/*
+ * AlgorithmThresholds:
+ * The cut-offs used by AutoSolver to pick a solver. The defaults suit a typical multi-core machine; the
+ * `mst_calibrate` benchmark measures them for the current machine and writes them as "key value" lines.
+ * Point the MST_THRESHOLDS environment variable at that file to use them.
+ */
+struct AlgorithmThresholds {
+    // At most this many edges: Prim, whose setup cost is the lowest.
+    int smallGraphEdges = 4096;
+    // E >= V^2 / denseRatioDivisor: Prim, which then runs its O(V^2) array version.
+    int denseRatioDivisor = PrimSolver::DENSE_RATIO_DIVISOR;
+    // At least this many edges and more than one core: `parallelAlgorithm`.
+    int parallelMinEdges = 1 << 18;
+    std::string parallelAlgorithm = "filter_kruskal";
+    // Weight ranges below this are sorted by IntegerMSTSolver's radix passes.
+    long long integerMaxRange = 1LL << (IntegerMSTSolver::RADIX_BITS * IntegerMSTSolver::MAX_RADIX_PASSES);
+    // Everything else.
+    std::string defaultAlgorithm = "kruskal";
+
+    // Reads "key value" lines; unknown keys and invalid values are ignored.
+    static AlgorithmThresholds load(std::istream& in);
+    // The file named by MST_THRESHOLDS (read once per process), or the defaults.
+    static const AlgorithmThresholds& fromEnvironment();
+    void save(std::ostream& out) const;
+};
+
+/*
+ * AutoSolver:
+ * Picks a solver from the size, density and weight range of the graph and the number of available threads,
+ * then delegates to it. Selected with `algo auto`.
+ */
+class AutoSolver : public MSTFactory {
+public:
+    explicit AutoSolver(int numThreads = 1, const AlgorithmThresholds& thresholds = AlgorithmThresholds::fromEnvironment());
     Graph solveMST(Graph& graph) override;
+    // The name of the solver used for `csr`.
+    static std::string choose(const CSRGraph& csr, const AlgorithmThresholds& thresholds, int numThreads);
+
+private:
+    int numThreads;
+    AlgorithmThresholds thresholds;
 };
 
 
@@ -76,6 +180,7 @@ public:
     UnionFind(int n);
     ~UnionFind();
     int find(int u);
+    int root(int u) const;
     bool unionSets(int u, int v);
 
 private:
@@ -83,4 +188,71 @@ private:
     std::vector<int> rank;
 };
 
+/*
+ * FibonacciHeap:
+ * Min-heap over the integer items 0..capacity-1 with O(1) amortized insert and decrease-key, and O(log n) amortized
+ * extract-min. Used by TarjanSolver. `clear()` only resets the items inserted since the previous clear.
+ */
+class FibonacciHeap {
+public:
+    explicit FibonacciHeap(int capacity);
+    bool empty() const;
+    int size() const;
+    bool contains(int item) const;
+    int keyOf(int item) const;
+    void insert(int item, int key);
+    void decreaseKey(int item, int key);
+    int extractMin();
+    void clear();
+
+private:
+    struct Node {
+        int key = 0;
+        int parent = -1, child = -1, left = -1, right = -1;
+        int degree = 0;
+        bool mark = false;
+        bool inHeap = false;
+    };
+    std::vector<Node> nodes;
+    std::vector<int> touched;   // Items inserted since the last clear.
+    std::vector<int> roots;     // Scratch buffers for extractMin.
+    std::vector<int> byDegree;
+    int minRoot;
+    int count;
+
+    void addRoot(int x);
+    void unlink(int x);
+    void cut(int x, int parent);
+    void link(int y, int x);
+};
+
+/*
+ * IndexedDaryHeap:
+ * Min-heap over the integer items 0..capacity-1 with ARITY children per node, ordered by (key, item).
+ * The position of every item is tracked, so decreaseKey moves an item in place instead of pushing a duplicate.
+ * Used by PrimSolver. The wide fan-out keeps the tree shallow and the children of a node on one cache line.
+ */
+class IndexedDaryHeap {
+public:
+    static constexpr int ARITY = 4;
+    explicit IndexedDaryHeap(int capacity);
+    bool empty() const;
+    int size() const;
+    bool contains(int item) const;
+    int keyOf(int item) const;
+    void insert(int item, int key);
+    void decreaseKey(int item, int key);
+    int extractMin();
+
+private:
+    std::vector<int> heap;      // Items in heap order.
+    std::vector<int> position;  // Index of each item in `heap`, or -1.
+    std::vector<int> keys;
+
+    bool less(int a, int b) const;
+    void place(int index, int item);
+    void siftUp(int index);
+    void siftDown(int index);
+};
+
 #endif  // MSTFACTORY_HPP
\ No newline at end of file
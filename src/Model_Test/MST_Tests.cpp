@@ -2,6 +2,29 @@
 #include "../../src/Model_Test/doctest.h"
 #include "../../src/Model/Graph.hpp"
 #include "../../src/Model/MSTFactory.hpp"
+#include "../../src/Network/MPSCQueue.hpp"
+#include "../../src/Network/ThreadPool.hpp"
+#include "../../src/Network/SocketWriter.hpp"
+#include "../../src/Network/BinaryProtocol.hpp"
+#include "../../src/Network/LineBuffer.hpp"
+#include "../../src/Network/ClientSession.hpp"
+#include "../../src/Network/ActiveObject.hpp"
+#include "../../src/Network/Server.hpp"
+#include "../../src/Network/Server_PL.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 MSTFactory* solverPrim = new PrimSolver();
 MSTFactory* solverKruskal = new KruskalSolver();
@@ -9,6 +32,53 @@ MSTFactory* solverBoruvka = new BoruvkaSolver();
 MSTFactory* solverTarjan = new TarjanSolver();
 MSTFactory* solverIntegerMST = new IntegerMSTSolver();
 
+// Validation oracle: the original O(V^3) Floyd-Warshall computation of the average distance in the MST.
+static double averageDistanceFloydWarshall(Graph& tree) {
+    int n = tree.getNumVertices();
+    const long long INF = std::numeric_limits<long long>::max();
+    std::vector<std::vector<long long>> dist(n, std::vector<long long>(n, INF));
+    for (int i = 0; i < n; ++i) {
+        dist[i][i] = 0;
+        for (const auto& [v, weight] : tree.getAdjList()[i]) {
+            dist[i][v] = weight;
+        }
+    }
+    for (int k = 0; k < n; ++k)
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (dist[i][k] < INF && dist[k][j] < INF)
+                    dist[i][j] = std::min(dist[i][j], dist[i][k] + dist[k][j]);
+
+    long long sumDistances = 0, count = 0;
+    for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j)
+            if (dist[i][j] < INF) {
+                sumDistances += dist[i][j];
+                ++count;
+            }
+    return count > 0 ? static_cast<double>(sumDistances) / count : 0.0;
+}
+
+// Builds a connected random graph: a random spanning path plus `extraEdges` random edges.
+static Graph randomConnectedGraph(int n, int extraEdges, int maxWeight, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_int_distribution<int> weight(1, maxWeight);
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), rng);
+
+    Graph g(n);
+    for (int i = 1; i < n; ++i) {
+        g.add_edge(perm[i - 1], perm[i], weight(rng));
+    }
+    for (int i = 0; i < extraEdges; ++i) {
+        int u = vertex(rng), v = vertex(rng);
+        if (u != v) g.add_edge(u, v, weight(rng));
+    }
+    return g;
+}
+
 TEST_CASE("Graph: Constructor and Initial State") {
     Graph g(5);
     CHECK(g.getNumVertices() == 5);
@@ -118,6 +188,28 @@ TEST_CASE("Graph: Invalid Operations") {
     CHECK(g.getTotalWeight() == 0);  // Total weight should remain 0
 }
 
+TEST_CASE("Graph: CSR Snapshot") {
+    Graph g(3);
+    g.add_edge(0, 1, 3);
+    g.add_edge(1, 2, 5);
+    g.add_edge(0, 2, 7);
+
+    const CSRGraph& csr = g.getCSR();
+    CHECK(csr.numVertices() == 3);
+    CHECK(csr.numEdges() == 3);
+    CHECK(csr.offsets == std::vector<int>{0, 2, 4, 6});
+    CHECK(csr.targets == std::vector<int>{1, 2, 0, 2, 1, 0});
+    CHECK(csr.weights == std::vector<int>{3, 7, 3, 5, 5, 7});
+
+    // Mutations invalidate the snapshot, which is rebuilt on the next access.
+    g.remove_edge(0, 2);
+    g.changeEdgeWeight(1, 2, 9);
+    const CSRGraph& refrozen = g.getCSR();
+    CHECK(refrozen.offsets == std::vector<int>{0, 1, 3, 4});
+    CHECK(refrozen.targets == std::vector<int>{1, 0, 2, 1});
+    CHECK(refrozen.weights == std::vector<int>{3, 3, 9, 9});
+}
+
 TEST_CASE("Test MST with an undirected graph of 3 vertices") {
     // Create a test graph
     Graph graph(3);
@@ -267,6 +359,1134 @@ TEST_CASE("MST: Total Weight Calculation") {
 
 }
 
+TEST_CASE("MST: Average Distance") {
+    Graph graph3(3);
+    graph3.add_edge(0, 1, 2);
+    graph3.add_edge(1, 2, 3);
+    graph3.add_edge(0, 2, 10);
+    graph3.Solve();
+    CHECK(graph3.getAverageDistance_MST() == doctest::Approx(10.0 / 3));
+
+    Graph graph5(5);
+    graph5.add_edge(0, 1, 2);
+    graph5.add_edge(1, 2, 3);
+    graph5.add_edge(0, 3, 6);
+    graph5.add_edge(1, 4, 5);
+    graph5.add_edge(3, 1, 8);
+    graph5.add_edge(4, 2, 7);
+    graph5.Solve();
+    CHECK(graph5.getAverageDistance_MST() == doctest::Approx(6.8));
+
+    // A single vertex has no pairs.
+    Graph single(1);
+    single.Solve();
+    CHECK(single.getAverageDistance_MST() == 0.0);
+}
+
+TEST_CASE("MST: Average Distance matches the Floyd-Warshall oracle") {
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        Graph g = randomConnectedGraph(60, 120, 50, seed);
+        g.Solve();
+        CHECK(g.getAverageDistance_MST() == doctest::Approx(averageDistanceFloydWarshall(*g.mst)));
+    }
+
+    // On a forest, only connected pairs are counted.
+    Graph forest(5);
+    forest.add_edge(0, 1, 4);
+    forest.add_edge(1, 2, 1);
+    forest.add_edge(3, 4, 7);
+    long long pairs = 0;
+    double sum = Graph::sumTreeDistances(forest.getCSR(), pairs);
+    CHECK(pairs == 4);
+    CHECK(sum / pairs == doctest::Approx(averageDistanceFloydWarshall(forest)));
+}
+
+TEST_CASE("MST: Tree summary kernel") {
+    //        0
+    //   (4) / \ (1)
+    //      1   2
+    // (2) /     \ (9)
+    //    3       4 --(1)-- 5
+    Graph tree(6);
+    tree.add_edge(0, 1, 4);
+    tree.add_edge(0, 2, 1);
+    tree.add_edge(1, 3, 2);
+    tree.add_edge(2, 4, 9);
+    tree.add_edge(4, 5, 1);
+    TreeSummary summary = Graph::summarizeTree(tree.getCSR());
+    CHECK(summary.totalWeight == 17);
+    CHECK(summary.depthPath == std::vector<int>{0, 2, 4, 5});
+    CHECK(summary.heaviestPath == std::vector<int>{5, 4, 2, 0, 1, 3});
+    CHECK(summary.heaviestPathWeights == std::vector<int>{1, 9, 1, 4, 2});
+    CHECK(summary.maxEdgeWeight == 9);
+    CHECK(summary.maxEdgeU == 2);
+    CHECK(summary.maxEdgeV == 4);
+    CHECK(summary.minEdgeWeight == 1);
+    CHECK(summary.minEdgeU == 0);
+    CHECK(summary.minEdgeV == 2);
+    CHECK(summary.pairCount == 15);
+    CHECK(summary.distanceSum / summary.pairCount == doctest::Approx(averageDistanceFloydWarshall(tree)));
+
+    // The getters are formatted from the same summary.
+    tree.Solve();
+    CHECK(tree.getTreeDepthPath_MST() == "0->2->4->5");
+    CHECK(tree.getMaxWeightPath_MST() == "Heaviest path: 5 --(1)--> 4 --(9)--> 2 --(1)--> 0 --(4)--> 1 --(2)--> 3");
+    CHECK(tree.getMaxWeightEdge_MST() == "Vertex 2 <----(9)----> Vertex 4");
+    CHECK(tree.getMinWeightEdge_MST() == "Vertex 0 <----(1)----> Vertex 2");
+
+    // The same numbers are available unformatted.
+    const MSTResult& result = tree.analyzeMST();
+    CHECK(result.vertices == 6);
+    REQUIRE(result.edges.size() == 5);
+    CHECK(result.edges[0].u == 0);
+    CHECK(result.edges[0].v == 1);
+    CHECK(result.edges[0].weight == 4);
+    CHECK(result.totalWeight == 17);
+    CHECK(result.heaviestEdge.weight == 9);
+    CHECK(result.lightestEdge.v == 2);
+    CHECK(result.heaviestPathWeights == std::vector<int>{1, 9, 1, 4, 2});
+}
+
+TEST_CASE("MST: Tree walker visits in recursive DFS order") {
+    Graph tree(6);
+    tree.add_edge(0, 1, 4);
+    tree.add_edge(0, 2, 1);
+    tree.add_edge(1, 3, 2);
+    tree.add_edge(2, 4, 9);
+    tree.add_edge(4, 5, 1);
+    const CSRGraph& csr = tree.getCSR();
+    TreeWalker walker(csr.numVertices());
+    std::vector<int> preOrder, postOrder;
+    int halfEdges = 0;
+    walker.walk(csr, 0, [&](int v) { preOrder.push_back(v); }, [&](int) { ++halfEdges; },
+                [&](int v) { postOrder.push_back(v); });
+    CHECK(preOrder == std::vector<int>{0, 1, 3, 2, 4, 5});
+    CHECK(postOrder == std::vector<int>{3, 1, 5, 4, 2, 0});
+    CHECK(halfEdges == 10);
+    CHECK(walker.parent[5] == 4);
+    CHECK(walker.hops[5] == 3);
+    CHECK(walker.distance[5] == 11);
+}
+
+TEST_CASE("MST: Tree summary of a 10M-vertex path") {
+    // A path 0 - 1 - ... - (n - 1) of unit weights: a recursive DFS would need one stack frame per vertex.
+    const int n = 10000000;
+    CSRGraph path;
+    path.offsets.resize(n + 1);
+    path.targets.reserve(2 * (n - 1));
+    for (int u = 0; u < n; ++u) {
+        path.offsets[u] = static_cast<int>(path.targets.size());
+        if (u > 0) path.targets.push_back(u - 1);
+        if (u + 1 < n) path.targets.push_back(u + 1);
+    }
+    path.offsets[n] = static_cast<int>(path.targets.size());
+    path.weights.assign(path.targets.size(), 1);
+
+    TreeSummary summary = Graph::summarizeTree(path);
+    CHECK(summary.totalWeight == n - 1);
+    REQUIRE(summary.depthPath.size() == static_cast<size_t>(n));
+    CHECK(summary.depthPath.back() == n - 1);
+    REQUIRE(summary.heaviestPath.size() == static_cast<size_t>(n));
+    CHECK(summary.heaviestPath.front() == n - 1);
+    CHECK(summary.heaviestPath.back() == 0);
+    CHECK(summary.pairCount == static_cast<long long>(n) * (n - 1) / 2);
+    // The sum of all pairwise distances on a unit path is C(n + 1, 3).
+    double expected = static_cast<double>(n + 1) * n * (n - 1) / 6;
+    CHECK(summary.distanceSum == doctest::Approx(expected));
+}
+
+TEST_CASE("MST: Dynamic maintenance on add/remove/changeEdgeWeight") {
+    Graph g(4);
+    g.setDynamicMST(true);
+    g.add_edge(0, 1, 10);
+    g.Solve();
+    CHECK(g.mst->getNumVertices() == 0);  // Disconnected: no MST yet.
+
+    g.add_edge(1, 2, 5);
+    g.add_edge(2, 3, 7);
+    CHECK(g.mst->getNumVertices() == 4);  // The insertion that connects the graph publishes the MST.
+    CHECK(g.getTotalWeight_MST() == 22);
+
+    g.add_edge(0, 3, 1);                  // Closes the cycle 0-1-2-3: swaps out (0, 1, 10).
+    CHECK(g.getTotalWeight_MST() == 13);
+
+    g.changeEdgeWeight(0, 3, 20);         // Heavier tree edge: replaced by (0, 1, 10).
+    CHECK(g.getTotalWeight_MST() == 22);
+
+    g.remove_edge(1, 2);                  // Tree edge: the only replacement is (0, 3, 20).
+    CHECK(g.getTotalWeight_MST() == 37);
+
+    g.add_edge(1, 3, 2);                  // Closes the cycle 1-0-3: swaps out (0, 3, 20).
+    CHECK(g.getTotalWeight_MST() == 19);
+
+    g.remove_edge(2, 3);                  // Tree edge without replacement: the graph is disconnected.
+    CHECK(g.mst->getNumVertices() == 0);
+}
+
+TEST_CASE("MST: Dynamic maintenance matches full recomputation") {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> vertex(0, 29);
+    std::uniform_int_distribution<int> weight(1, 20);
+    std::uniform_int_distribution<int> operation(0, 9);
+
+    Graph dynamicGraph(30);
+    dynamicGraph.setDynamicMST(true);
+    dynamicGraph.Solve();
+    for (int step = 0; step < 2000; ++step) {
+        int u = vertex(rng), v = vertex(rng), op = operation(rng);
+        if (op < 6) dynamicGraph.add_edge(u, v, weight(rng));
+        else if (op < 8) dynamicGraph.remove_edge(u, v);
+        else dynamicGraph.changeEdgeWeight(u, v, weight(rng));
+        dynamicGraph.Solve();
+
+        Graph expected = solverKruskal->solveMST(dynamicGraph);
+        REQUIRE(dynamicGraph.mst->getNumVertices() == expected.getNumVertices());
+        REQUIRE(dynamicGraph.getTotalWeight_MST() == expected.getTotalWeight());
+    }
+}
+
+TEST_CASE("Graph: Lazy Solve and cached analytics") {
+    Graph g(4);
+    g.add_edge(0, 1, 10);
+    g.add_edge(0, 2, 5);
+    g.add_edge(1, 2, 7);
+    g.add_edge(2, 3, 3);
+
+    g.Solve();
+    Graph* firstMST = g.mst.get();
+    std::string report = g.Analysis();
+    CHECK(g.getTotalWeight_MST() == 15);
+
+    // Nothing changed: the MST is not rebuilt and the report is served from the cache.
+    uint64_t version = g.getVersion();
+    g.Solve();
+    g.setAlgorithm("prim");
+    CHECK(g.getVersion() == version);
+    CHECK(g.mst.get() == firstMST);
+    CHECK(g.Analysis() == report);
+
+    // Invalid mutations do not dirty the graph.
+    g.remove_edge(0, 3);
+    g.changeEdgeWeight(1, 3, 4);
+    CHECK(g.getVersion() == version);
+
+    // Changing the algorithm or an edge triggers a recomputation.
+    g.setAlgorithm("kruskal");
+    CHECK(g.getVersion() != version);
+    g.Solve();
+    CHECK(g.mst.get() != firstMST);
+    CHECK(g.Analysis().find("Algorithm: kruskal") != std::string::npos);
+
+    g.changeEdgeWeight(2, 3, 1);
+    g.Solve();
+    CHECK(g.getTotalWeight_MST() == 13);
+    CHECK(g.getMinWeightEdge_MST().find("<----(1)---->") != std::string::npos);
+}
+
+TEST_CASE("Graph: Parallel analysis matches the sequential getters") {
+    int n = Graph::PARALLEL_ANALYSIS_MIN_VERTICES * 2;
+    Graph g = randomConnectedGraph(n, 3 * n, 1000, 7);
+    Graph reference(g);
+    g.Solve();
+    reference.Solve();
+
+    const MSTResult& result = g.analyzeMST();
+    const MSTResult& sequential = reference.analyzeMST(false);
+    CHECK(result.vertices == n);
+    CHECK(result.edges.size() == static_cast<size_t>(n - 1));
+    CHECK(result.totalWeight == reference.getTotalWeight_MST());
+    CHECK(result.averageDistance == doctest::Approx(reference.getAverageDistance_MST()));
+    CHECK(result.longestPath == sequential.longestPath);
+    CHECK(result.heaviestPath == sequential.heaviestPath);
+    CHECK(Graph::formatLongestPath(result) == reference.getTreeDepthPath_MST());
+    CHECK(Graph::formatHeaviestPath(result) == reference.getMaxWeightPath_MST());
+    CHECK(Graph::formatEdge(result.heaviestEdge) == reference.getMaxWeightEdge_MST());
+    CHECK(Graph::formatEdge(result.lightestEdge) == reference.getMinWeightEdge_MST());
+
+    // The parallel report is identical to the one assembled from the sequential getters.
+    std::string expected = "\n" + reference.displayGraph() + reference.displayMST() +
+                           Graph::formatAnalysis(reference.getAlgorithm(), reference.analyzeMST(false));
+    CHECK(g.Analysis() == expected);
+}
+
+TEST_CASE("Graph: Streamed report matches Analysis") {
+    for (int n : {6, Graph::PARALLEL_ANALYSIS_MIN_VERTICES * 2}) {
+        Graph g = randomConnectedGraph(n, 3 * n, 1000, 11);
+        g.Solve();
+        std::string streamed;
+        StringSink sink(streamed);
+        g.writeAnalysis(sink);
+        CHECK(streamed == g.Analysis());
+    }
+}
+
+TEST_CASE("Graph: Report cursor writes Analysis in bounded chunks") {
+    for (int n : {2, 6, 5000}) {
+        Graph g = randomConnectedGraph(n, 3 * n, 1000, 13);
+        g.Solve();
+        for (size_t budget : {size_t(1), size_t(100), size_t(64 * 1024)}) {
+            ReportCursor cursor(g);
+            std::string report;
+            StringSink sink(report);
+            size_t longestChunk = 0;
+            bool more = true;
+            while (more) {
+                size_t before = report.size();
+                more = cursor.next(sink, budget);
+                if (more) longestChunk = std::max(longestChunk, report.size() - before);
+            }
+            CHECK(report == g.Analysis());
+            CHECK(longestChunk < budget + 4096); // At most one line or title past the budget.
+        }
+    }
+}
+
+TEST_CASE("Socket writer: chunked output under backpressure") {
+    int n = 200000;
+    Graph g = randomConnectedGraph(n, 2 * n, 1000, 5);
+    g.Solve();
+    std::string expected = g.Analysis();
+    REQUIRE(expected.size() > 4 * SocketWriter::BUFFER_SIZE);
+
+    // A small, non-blocking send buffer and a slow reader force partial writes and waits for writability.
+    int sockets[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+    int sendBuffer = 4096;
+    setsockopt(sockets[0], SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+    fcntl(sockets[0], F_SETFL, fcntl(sockets[0], F_GETFL, 0) | O_NONBLOCK);
+    std::string received;
+    std::thread reader([&]() {
+        char chunk[16384];
+        ssize_t count;
+        while ((count = read(sockets[1], chunk, sizeof(chunk))) > 0) {
+            received.append(chunk, static_cast<size_t>(count));
+            if (received.size() < 256 * 1024) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    SocketWriter writer(sockets[0]);
+    writer.write("header\n");
+    g.writeAnalysis(writer);
+    std::string large(3 * SocketWriter::BUFFER_SIZE, 'x'); // Larger than the buffer: sent without staging.
+    writer.write(large);
+    CHECK(writer.flush());
+    CHECK(writer.bytesSent() == 7 + expected.size() + large.size());
+    close(sockets[0]);
+    reader.join();
+    close(sockets[1]);
+    CHECK(received == "header\n" + expected + large);
+}
+
+TEST_CASE("Tarjan (Fredman-Tarjan) matches Kruskal on large random graphs") {
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        Graph g = randomConnectedGraph(20000, 200000, 1000, seed);
+        Graph mstKruskal = solverKruskal->solveMST(g);
+        Graph mstTarjan = solverTarjan->solveMST(g);
+        CHECK(mstTarjan.getNumVertices() == 20000);
+        CHECK(mstTarjan.getCSR().numEdges() == 19999);
+        CHECK(mstTarjan.getTotalWeight() == mstKruskal.getTotalWeight());
+    }
+
+    // Many equal weights: ties must not create cycles.
+    Graph ties = randomConnectedGraph(5000, 50000, 3, 7);
+    CHECK(solverTarjan->solveMST(ties).getTotalWeight() == solverKruskal->solveMST(ties).getTotalWeight());
+}
+
+TEST_CASE("Tarjan (Fredman-Tarjan) vs Kruskal on a dense graph") {
+    // Dense inputs are where Fredman-Tarjan wins: O(1) decrease-key instead of sorting every edge.
+    const int n = 800;
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> weight(1, 1000000);
+    Graph dense(n);
+    for (int u = 0; u < n; ++u)
+        for (int v = u + 1; v < n; v += 3)
+            dense.add_edge(u, v, weight(rng));
+    dense.add_edge(0, 1, 1);
+    dense.getCSR();
+
+    auto time = [&](MSTFactory* solver, double& weightOut) {
+        auto start = std::chrono::steady_clock::now();
+        weightOut = solver->solveMST(dense).getTotalWeight();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    double kruskalWeight = 0, tarjanWeight = 0;
+    double kruskalMs = time(solverKruskal, kruskalWeight);
+    double tarjanMs = time(solverTarjan, tarjanWeight);
+    CHECK(tarjanWeight == kruskalWeight);
+    MESSAGE("Dense graph (" << dense.getCSR().numEdges() << " edges): kruskal " << kruskalMs << " ms, tarjan " << tarjanMs << " ms");
+}
+
+TEST_CASE("Integer MST: radix sort, counting sort and wide-range fallback") {
+    // Narrow range (one counting-sort pass), two radix passes, and a range too wide for radix passes.
+    for (int maxWeight : {100, 1000000, 2000000000}) {
+        Graph g = randomConnectedGraph(3000, 30000, maxWeight, maxWeight);
+        CHECK(solverIntegerMST->solveMST(g).getTotalWeight() == solverKruskal->solveMST(g).getTotalWeight());
+    }
+
+    // Negative weights are shifted by the minimum weight before sorting.
+    Graph negative(4);
+    negative.add_edge(0, 1, -5);
+    negative.add_edge(1, 2, 3);
+    negative.add_edge(2, 3, -7);
+    negative.add_edge(0, 3, 1);
+    negative.add_edge(0, 2, -1);
+    CHECK(solverIntegerMST->solveMST(negative).getTotalWeight() == -13);
+}
+
+TEST_CASE("Integer MST vs Prim and Kruskal on integer weights") {
+    Graph g = randomConnectedGraph(50000, 500000, 10000, 11);
+    g.getCSR();
+
+    auto time = [&](MSTFactory* solver, double& weightOut) {
+        auto start = std::chrono::steady_clock::now();
+        weightOut = solver->solveMST(g).getTotalWeight();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    double primWeight = 0, kruskalWeight = 0, integerWeight = 0;
+    double primMs = time(solverPrim, primWeight);
+    double kruskalMs = time(solverKruskal, kruskalWeight);
+    double integerMs = time(solverIntegerMST, integerWeight);
+    CHECK(integerWeight == kruskalWeight);
+    CHECK(integerWeight == primWeight);
+    MESSAGE("Integer weights (" << g.getCSR().numEdges() << " edges): prim " << primMs << " ms, kruskal "
+            << kruskalMs << " ms, integer_mst " << integerMs << " ms");
+}
+
+TEST_CASE("Parallel Borůvka matches Kruskal") {
+    BoruvkaSolver parallelBoruvka(4);
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = randomConnectedGraph(30000, 150000, 50, seed);
+        Graph expected = solverKruskal->solveMST(g);
+        Graph mstParallel = parallelBoruvka.solveMST(g);
+        CHECK(mstParallel.getCSR().numEdges() == 29999);
+        CHECK(mstParallel.getTotalWeight() == expected.getTotalWeight());
+        CHECK(solverBoruvka->solveMST(g).getTotalWeight() == expected.getTotalWeight());
+    }
+
+    Graph disconnected(20000);
+    for (int v = 1; v < 20000; ++v) {
+        if (v != 10000) disconnected.add_edge(v - 1, v, v % 7);
+    }
+    CHECK(parallelBoruvka.solveMST(disconnected).getNumVertices() == 0);
+}
+
+TEST_CASE("Filter-Kruskal matches Kruskal") {
+    FilterKruskalSolver parallelFilterKruskal(4);
+    FilterKruskalSolver filterKruskal;
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = randomConnectedGraph(30000, 150000, 1000, seed);
+        Graph expected = solverKruskal->solveMST(g);
+        Graph mstParallel = parallelFilterKruskal.solveMST(g);
+        CHECK(mstParallel.getCSR().numEdges() == 29999);
+        CHECK(mstParallel.getTotalWeight() == expected.getTotalWeight());
+        CHECK(filterKruskal.solveMST(g).getTotalWeight() == expected.getTotalWeight());
+    }
+
+    // All weights equal: the pivot cannot split the edges.
+    Graph equal = randomConnectedGraph(5000, 20000, 1, 7);
+    Graph mstEqual = parallelFilterKruskal.solveMST(equal);
+    CHECK(mstEqual.getCSR().numEdges() == 4999);
+    CHECK(mstEqual.getTotalWeight() == solverKruskal->solveMST(equal).getTotalWeight());
+
+    Graph disconnected(20000);
+    for (int v = 1; v < 20000; ++v) {
+        if (v != 10000) disconnected.add_edge(v - 1, v, v % 7);
+    }
+    CHECK(parallelFilterKruskal.solveMST(disconnected).getNumVertices() == 0);
+
+    Graph g(4);
+    g.add_edge(0, 1, 3);
+    g.add_edge(1, 2, 1);
+    g.add_edge(2, 3, 2);
+    g.add_edge(0, 3, 5);
+    g.setAlgorithm("filter_kruskal");
+    g.Solve();
+    CHECK(g.getTotalWeight_MST() == 6);
+}
+
+TEST_CASE("Indexed d-ary heap with decrease-key") {
+    IndexedDaryHeap heap(100);
+    std::mt19937 rng(5);
+    std::vector<int> keys(100);
+    for (int item = 0; item < 100; ++item) {
+        keys[item] = static_cast<int>(rng() % 1000) + 1000;
+        heap.insert(item, keys[item]);
+    }
+    for (int item = 0; item < 100; item += 3) {
+        keys[item] -= static_cast<int>(rng() % 1000);
+        heap.decreaseKey(item, keys[item]);
+    }
+    CHECK(heap.size() == 100);
+    CHECK(heap.keyOf(3) == keys[3]);
+
+    int previous = -1;
+    while (!heap.empty()) {
+        int item = heap.extractMin();
+        CHECK_FALSE(heap.contains(item));
+        CHECK(keys[item] >= previous);
+        previous = keys[item];
+    }
+}
+
+TEST_CASE("Prim: heap and dense paths match Kruskal") {
+    // Sparse: E/V = 5, well below the dense threshold.
+    Graph sparse = randomConnectedGraph(20000, 80000, 100, 11);
+    CHECK(solverPrim->solveMST(sparse).getTotalWeight() == solverKruskal->solveMST(sparse).getTotalWeight());
+
+    // Dense: about 3/4 of all pairs.
+    Graph dense(600);
+    std::mt19937 rng(12);
+    for (int u = 0; u < 600; ++u) {
+        for (int v = u + 1; v < 600; ++v) {
+            if (rng() % 4 != 0) dense.add_edge(u, v, static_cast<int>(rng() % 10000));
+        }
+    }
+    REQUIRE(dense.getCSR().numEdges() * static_cast<long long>(PrimSolver::DENSE_RATIO_DIVISOR) >= 600LL * 600);
+    Graph mstDense = solverPrim->solveMST(dense);
+    CHECK(mstDense.getCSR().numEdges() == 599);
+    CHECK(mstDense.getTotalWeight() == solverKruskal->solveMST(dense).getTotalWeight());
+
+    Graph disconnected(600);
+    for (int u = 0; u < 600; ++u) {
+        for (int v = u + 1; v < 600; ++v) {
+            if ((u < 300) == (v < 300)) disconnected.add_edge(u, v, u + v);
+        }
+    }
+    CHECK(solverPrim->solveMST(disconnected).getNumVertices() == 0);
+}
+
+TEST_CASE("Auto: algorithm selection from graph statistics") {
+    AlgorithmThresholds thresholds;
+    thresholds.smallGraphEdges = 100;
+    thresholds.denseRatioDivisor = 8;
+    thresholds.parallelMinEdges = 5000;
+
+    Graph small = randomConnectedGraph(50, 40, 10, 1);
+    CHECK(AutoSolver::choose(small.getCSR(), thresholds, 4) == "prim");
+
+    Graph dense(60);
+    for (int u = 0; u < 60; ++u) {
+        for (int v = u + 1; v < 60; ++v) dense.add_edge(u, v, u * v);
+    }
+    CHECK(AutoSolver::choose(dense.getCSR(), thresholds, 4) == "prim");
+
+    Graph sparse = randomConnectedGraph(2000, 6000, 1000, 2);
+    CHECK(AutoSolver::choose(sparse.getCSR(), thresholds, 4) == "filter_kruskal");
+    CHECK(AutoSolver::choose(sparse.getCSR(), thresholds, 1) == "integer_mst");
+
+    Graph wide = randomConnectedGraph(2000, 6000, 1000, 3);
+    wide.add_edge(0, 1, std::numeric_limits<int>::max());
+    CHECK(AutoSolver::choose(wide.getCSR(), thresholds, 1) == "kruskal");
+
+    std::istringstream file("# tuned\nsmallGraphEdges 7\nparallelAlgorithm boruvka\ndefaultAlgorithm nope\nparallelMinEdges x\n");
+    AlgorithmThresholds loaded = AlgorithmThresholds::load(file);
+    CHECK(loaded.smallGraphEdges == 7);
+    CHECK(loaded.parallelAlgorithm == "boruvka");
+    CHECK(loaded.defaultAlgorithm == "kruskal");
+    CHECK(loaded.parallelMinEdges == AlgorithmThresholds().parallelMinEdges);
+
+    std::stringstream roundTrip;
+    thresholds.save(roundTrip);
+    CHECK(AlgorithmThresholds::load(roundTrip).parallelMinEdges == 5000);
+
+    AutoSolver autoSolver(4, thresholds);
+    for (Graph* g : {&small, &dense, &sparse, &wide}) {
+        CHECK(autoSolver.solveMST(*g).getTotalWeight() == solverKruskal->solveMST(*g).getTotalWeight());
+    }
+    sparse.setAlgorithm("auto");
+    sparse.Solve();
+    CHECK(sparse.getTotalWeight_MST() == solverKruskal->solveMST(sparse).getTotalWeight());
+}
+
+TEST_CASE("Edge index: lookups follow add/remove/changeEdgeWeight, copies and moves") {
+    std::mt19937 rng(21);
+    Graph g(300);
+    std::map<std::pair<int, int>, int> expected;
+    for (int step = 0; step < 20000; ++step) {
+        int u = static_cast<int>(rng() % 300), v = static_cast<int>(rng() % 300);
+        std::pair<int, int> key(std::min(u, v), std::max(u, v));
+        int op = static_cast<int>(rng() % 3);
+        if (op == 0) {
+            int w = static_cast<int>(rng() % 100);
+            g.add_edge(u, v, w);
+            expected[key] = w;
+        } else if (op == 1) {
+            g.remove_edge(u, v);
+            expected.erase(key);
+        } else {
+            int w = static_cast<int>(rng() % 100);
+            g.changeEdgeWeight(u, v, w);
+            if (expected.count(key)) expected[key] = w;
+        }
+    }
+
+    auto matches = [&expected](Graph& graph) {
+        size_t halfEdges = 0;
+        for (int u = 0; u < graph.getNumVertices(); ++u) halfEdges += graph.getAdjList()[u].size();
+        if (halfEdges != 2 * expected.size()) return false;
+        for (int u = 0; u < 300; ++u) {
+            for (int v = 0; v < 300; ++v) {
+                auto it = expected.find({std::min(u, v), std::max(u, v)});
+                int weight = -1;
+                if (graph.getEdgeWeight(u, v, weight) != (it != expected.end())) return false;
+                if (it != expected.end() && weight != it->second) return false;
+            }
+        }
+        return true;
+    };
+    CHECK(matches(g));
+
+    Graph copy(g);
+    Graph assigned(1);
+    assigned = g;
+    Graph moved(std::move(copy));
+    CHECK(matches(assigned));
+    CHECK(matches(moved));
+    auto edge = expected.begin()->first;
+    moved.remove_edge(edge.first, edge.second);
+    CHECK_FALSE(moved.hasEdge(edge.second, edge.first));
+    CHECK(g.hasEdge(edge.first, edge.second));
+    CHECK(copy.getNumVertices() == 0);
+    CHECK_FALSE(copy.hasEdge(0, 1));
+
+    // A hub with many neighbors: each mutation is O(1) instead of a scan of the hub's list.
+    Graph hub(200001);
+    for (int v = 1; v <= 200000; ++v) hub.add_edge(0, v, v);
+    for (int v = 1; v <= 200000; v += 2) hub.remove_edge(v, 0);
+    hub.changeEdgeWeight(0, 200000, 7);
+    int weight = 0;
+    CHECK(hub.getEdgeWeight(200000, 0, weight));
+    CHECK(weight == 7);
+    CHECK(hub.getAdjList()[0].size() == 100000);
+}
+
+TEST_CASE("Graph: add_edges applies a batch like repeated add_edge") {
+    std::vector<WeightedEdge> edges = {{0, 1, 4}, {1, 2, 3}, {2, 3, 2}, {3, 0, 1}, {0, 2, 9}, {1, 0, 5}, {4, 9, 1}};
+    Graph batch(4), single(4);
+    for (const WeightedEdge& edge : edges) single.add_edge(edge.u, edge.v, edge.weight);
+    uint64_t before = batch.getVersion();
+    CHECK(batch.add_edges(edges) == 6); // (4, 9) has invalid vertices.
+    CHECK(batch.getVersion() != before);
+    CHECK(batch.compareGraphs(single));
+    int weight = 0;
+    CHECK(batch.getEdgeWeight(0, 1, weight));
+    CHECK(weight == 5);
+    CHECK(batch.add_edges(edges.data() + 6, 1) == 0);
+
+    // Dynamic mode: the batch invalidates the forest, and the next Solve() rebuilds it once.
+    Graph g = randomConnectedGraph(500, 1000, 100, 4);
+    g.setDynamicMST(true);
+    g.Solve();
+    std::vector<WeightedEdge> more;
+    std::mt19937 rng(4);
+    for (int i = 0; i < 2000; ++i) {
+        more.push_back({static_cast<int>(rng() % 500), static_cast<int>(rng() % 500), static_cast<int>(rng() % 100)});
+    }
+    g.add_edges(more);
+    g.Solve();
+    CHECK(g.getTotalWeight_MST() == solverKruskal->solveMST(g).getTotalWeight());
+    g.add_edge(0, 499, -1000);
+    CHECK(g.getTotalWeight_MST() == solverKruskal->solveMST(g).getTotalWeight());
+}
+
+TEST_CASE("MPSC queue: lock-free multi-producer delivery with parking") {
+    MPSCQueue<int> queue(5);
+    CHECK(queue.capacity() == 8);
+    for (int i = 0; i < 8; ++i) {
+        int value = i;
+        CHECK(queue.tryPush(value));
+    }
+    int extra = 8;
+    CHECK_FALSE(queue.tryPush(extra)); // Full.
+    for (int i = 0; i < 8; ++i) {
+        int value = -1;
+        CHECK(queue.tryPop(value));
+        CHECK(value == i);
+    }
+    int none;
+    CHECK_FALSE(queue.tryPop(none));
+
+    // Several producers on a small ring: every element arrives once, in each producer's order, and both the
+    // producers (full ring) and the consumer (empty ring) have to park.
+    const int PRODUCERS = 4, PER_PRODUCER = 50000;
+    MPSCQueue<std::pair<int, int>> shared(16);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&shared, p]() {
+            for (int i = 0; i < PER_PRODUCER; ++i) shared.push({p, i});
+        });
+    }
+    std::vector<int> next(PRODUCERS, 0);
+    bool ordered = true;
+    std::thread consumer([&]() {
+        std::pair<int, int> item;
+        while (shared.pop(item)) {
+            ordered = ordered && item.second == next[item.first];
+            ++next[item.first];
+        }
+    });
+    for (std::thread& producer : producers) producer.join();
+    shared.close();
+    consumer.join();
+    CHECK(ordered);
+    for (int p = 0; p < PRODUCERS; ++p) CHECK(next[p] == PER_PRODUCER);
+}
+
+TEST_CASE("Active object: back-pressure and throughput counters") {
+    ActiveObject stage(2);
+    stage.start();
+
+    // The worker is held by the first task while two more fill the queue: the next producer must wait.
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> executed{0};
+    std::atomic<bool> started{false};
+    stage.enqueue([gate, &executed, &started]() { started = true; gate.wait(); ++executed; });
+    while (!started) std::this_thread::yield();
+    stage.enqueue([&executed]() { ++executed; });
+    stage.enqueue([&executed]() { ++executed; });
+    std::atomic<bool> enqueued{false};
+    std::thread producer([&]() {
+        stage.enqueue([&executed]() { ++executed; });
+        enqueued = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK_FALSE(enqueued.load());
+    CHECK(stage.tasksExecuted() == 0);
+    release.set_value();
+    producer.join();
+    CHECK(enqueued.load());
+
+    stage.enqueue([]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+    stage.stop(); // Runs the queued tasks first.
+    CHECK(executed == 4);
+    CHECK(stage.tasksExecuted() == 5);
+    CHECK(stage.busyTimeNanoseconds() >= 20000000u);
+}
+
+// Serves one connection on the calling thread, as the accept loop would on a client thread. The client's
+// `shutdown` removes the last client, which stops the server and closes its listening socket.
+class PipelineTestServer : public Server_PL {
+public:
+    explicit PipelineTestServer(int port) : Server_PL("127.0.0.1", port) {}
+    void serve(int client_socket) {
+        running = true;
+        addClient(client_socket);
+        handleClient(client_socket);
+    }
+};
+
+TEST_CASE("Pipeline server: a request passes through every stage") {
+    int sockets[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+    std::unique_ptr<PipelineTestServer> server;
+    for (int port = 28080; !server; ++port) { // The listening socket is not used, but it needs a free port.
+        try {
+            server = std::make_unique<PipelineTestServer>(port);
+        } catch (const std::runtime_error&) {
+            REQUIRE(port < 28180);
+        }
+    }
+    std::thread client([&]() { server->serve(sockets[0]); });
+
+    const std::string commands = "create 4\nadd 0 1 4\nadd 1 2 2\nadd 2 3 7\nadd 0 3 1\n";
+    REQUIRE(write(sockets[1], commands.data(), commands.size()) == static_cast<ssize_t>(commands.size()));
+    std::string received;
+    char chunk[4096];
+    const std::string reportEnd = std::string(15, ' ') + std::string(55, '-') + "\n";
+    while (received.size() < reportEnd.size() || received.compare(received.size() - reportEnd.size(), reportEnd.size(), reportEnd) != 0) {
+        ssize_t count = read(sockets[1], chunk, sizeof(chunk));
+        REQUIRE(count > 0);
+        received.append(chunk, static_cast<size_t>(count));
+    }
+    REQUIRE(write(sockets[1], "shutdown\n", 9) == 9);
+    client.join();
+    close(sockets[1]);
+
+    Graph reference(4);
+    reference.setDynamicMST(true);
+    reference.add_edge(0, 1, 4);
+    reference.add_edge(1, 2, 2);
+    reference.add_edge(2, 3, 7);
+    reference.add_edge(0, 3, 1);
+    reference.Solve();
+    // Replies, then the report (which, in this mode, has no leading blank line).
+    std::string expected = ClientSession::helpMenu() + "Graph created with 4 vertices.\n" +
+                           "Edge added: (0, 1) with weight 4\nEdge added: (1, 2) with weight 2\n" +
+                           "Edge added: (2, 3) with weight 7\nEdge added: (0, 3) with weight 1\n" +
+                           reference.Analysis().substr(1);
+    CHECK(received == expected);
+
+    std::string statistics = server->stageStatistics();
+    for (int stage = 1; stage <= 3; ++stage) {
+        CHECK(statistics.find("Stage " + std::to_string(stage) + ": 1 requests") != std::string::npos);
+    }
+}
+
+// Recursive fork/join: sums [lo, hi) by splitting until the ranges are small.
+static long long forkJoinSum(ThreadPool& pool, long long lo, long long hi) {
+    if (hi - lo <= 1000) {
+        long long sum = 0;
+        for (long long i = lo; i < hi; ++i) sum += i;
+        return sum;
+    }
+    long long mid = lo + (hi - lo) / 2, left = 0;
+    TaskGroup group(pool);
+    group.run([&]() { left = forkJoinSum(pool, lo, mid); });
+    long long right = forkJoinSum(pool, mid, hi);
+    group.wait();
+    return left + right;
+}
+
+TEST_CASE("Work-stealing deque and thread pool") {
+    // Owner takes LIFO, thieves steal FIFO, and the ring grows past its initial capacity.
+    WorkStealingDeque<int*> deque(4);
+    std::vector<int> values(100);
+    for (int i = 0; i < 100; ++i) {
+        values[i] = i;
+        deque.push(&values[i]);
+    }
+    CHECK(deque.size() == 100);
+    int* item = nullptr;
+    CHECK(deque.steal(item) == WorkStealingDeque<int*>::StealStatus::Success);
+    CHECK(*item == 0);
+    CHECK(*deque.take() == 99);
+
+    // Owner and thieves racing: every element is removed exactly once.
+    std::vector<std::atomic<int>> seen(100000);
+    std::vector<int> items(100000);
+    WorkStealingDeque<int*> shared;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&]() {
+            while (!done.load()) {
+                int* stolen = nullptr;
+                if (shared.steal(stolen) == WorkStealingDeque<int*>::StealStatus::Success) seen[*stolen]++;
+            }
+        });
+    }
+    for (int i = 0; i < 100000; ++i) {
+        items[i] = i;
+        shared.push(&items[i]);
+        if (i % 3 == 0) {
+            if (int* taken = shared.take()) seen[*taken]++;
+        }
+    }
+    while (int* taken = shared.take()) seen[*taken]++;
+    done = true;
+    for (std::thread& thief : thieves) thief.join();
+    bool once = true;
+    for (auto& count : seen) once = once && count.load() == 1;
+    CHECK(once);
+
+    ThreadPool pool(4);
+    CHECK(pool.size() == 4);
+    CHECK(forkJoinSum(pool, 0, 1000000) == 499999500000LL);
+
+    std::vector<int> hits(10007, 0);
+    pool.parallelFor(7, 10007, [&](int, int lo, int hi) {
+        for (int i = lo; i < hi; ++i) hits[i]++;
+    });
+    CHECK(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+
+    TaskGroup failing(pool);
+    failing.run([]() { throw std::runtime_error("task failed"); });
+    CHECK_THROWS_AS(failing.wait(), std::runtime_error);
+}
+
+TEST_CASE("Task: move-only closures with inline storage") {
+    CHECK(sizeof(Task) == 64);
+    int calls = 0;
+    auto small = [&calls, a = 1, b = 2.0]() { calls += a + static_cast<int>(b); };
+    CHECK(Task::fitsInline<decltype(small)>());
+    auto big = [&calls, padding = std::array<char, 100>{}]() { calls += 10 + padding[0]; };
+    CHECK_FALSE(Task::fitsInline<decltype(big)>());
+
+    Task inlineTask(small), heapTask(big), empty;
+    CHECK_FALSE(empty);
+    inlineTask();
+    heapTask();
+    CHECK(calls == 13);
+
+    // Moving transfers the callable (inline or not) and leaves the source empty.
+    Task moved(std::move(inlineTask));
+    CHECK_FALSE(inlineTask);
+    moved();
+    empty = std::move(heapTask);
+    empty();
+    CHECK(calls == 26);
+
+    // Move-only captures are accepted, and destroyed with the task.
+    auto owned = std::make_shared<int>(5);
+    std::weak_ptr<int> watch = owned;
+    Task holder([value = std::unique_ptr<int>(new int(7)), owned = std::move(owned), &calls]() { calls += *value; });
+    holder();
+    CHECK(calls == 33);
+    CHECK_FALSE(watch.expired());
+    holder = nullptr;
+    CHECK(watch.expired());
+}
+
+// Pushes `bytes` through a pipe into `buffer` a piece at a time, as a socket would deliver them, and returns the
+// lines extracted after each read (an oversized line shows up as "<too long>").
+static std::vector<std::string> feedLines(LineBuffer& buffer, const std::string& bytes, size_t piece = 4096) {
+    int pipeEnds[2];
+    REQUIRE(pipe(pipeEnds) == 0);
+    std::vector<std::string> lines;
+    for (size_t offset = 0; offset < bytes.size();) {
+        size_t count = std::min(piece, bytes.size() - offset);
+        REQUIRE(write(pipeEnds[1], bytes.data() + offset, count) == static_cast<ssize_t>(count));
+        offset += count;
+        while (count > 0) {
+            long n = buffer.readFrom(pipeEnds[0]);
+            REQUIRE(n > 0);
+            count -= static_cast<size_t>(n);
+            std::string line;
+            LineBuffer::LineStatus status;
+            while ((status = buffer.nextLine(line)) != LineBuffer::LineStatus::None) {
+                lines.push_back(status == LineBuffer::LineStatus::Line ? line : "<too long>");
+            }
+        }
+    }
+    close(pipeEnds[0]);
+    close(pipeEnds[1]);
+    return lines;
+}
+
+TEST_CASE("Line buffer: framing of a byte stream") {
+    LineBuffer buffer;
+    // Several commands in one read, a line split across reads, and a CRLF terminator.
+    CHECK(feedLines(buffer, "create 5\nadd 0 1 2\nadd 1") == std::vector<std::string>{"create 5", "add 0 1 2"});
+    CHECK(buffer.size() == 5);
+    char first[3];
+    buffer.peek(first, 3);
+    CHECK(std::string(first, 3) == "add");
+    CHECK(feedLines(buffer, " 2 3\r\n\n") == std::vector<std::string>{"add 1 2 3", ""});
+    CHECK(buffer.size() == 0);
+
+    // Lines straddling the end of the ring come out whole, in order.
+    std::string stream, expected;
+    std::vector<std::string> lines;
+    for (int i = 0; i < 2000; ++i) {
+        lines.push_back("add " + std::to_string(i) + " " + std::to_string(i + 1) + " 7");
+        stream += lines.back() + "\n";
+    }
+    CHECK(feedLines(buffer, stream, 1000) == lines);
+
+    // A line longer than MAX_LINE_LENGTH is reported once, whether it is still buffered when its newline arrives
+    // or was already dropped because it filled the largest ring; the next line is intact.
+    std::string longLine(LineBuffer::MAX_LINE_LENGTH + 100, 'x');
+    CHECK(feedLines(buffer, longLine + "\nremove 0 1\n") == std::vector<std::string>{"<too long>", "remove 0 1"});
+    std::string hugeLine(3 * LineBuffer::MAX_LINE_LENGTH, 'y');
+    CHECK(feedLines(buffer, hugeLine + "\nshutdown\n") == std::vector<std::string>{"<too long>", "shutdown"});
+
+    CHECK(feedLines(buffer, "MSTB\x01\x02").empty());
+    CHECK(buffer.takeAll() == "MSTB\x01\x02");
+    CHECK(buffer.size() == 0);
+}
+
+// Feeds `bytes` to a session in pieces of `piece` bytes and returns everything it wrote; `open` receives the
+// result of the last `processLines()` call.
+static std::string runSession(ClientSession& session, LineBuffer& input, const std::string& bytes, bool& open,
+                              size_t piece = 4096) {
+    int pipeEnds[2];
+    REQUIRE(pipe(pipeEnds) == 0);
+    std::string output;
+    StringSink sink(output);
+    open = true;
+    for (size_t offset = 0; offset < bytes.size() && open; offset += piece) {
+        size_t count = std::min(piece, bytes.size() - offset);
+        REQUIRE(write(pipeEnds[1], bytes.data() + offset, count) == static_cast<ssize_t>(count));
+        for (size_t received = 0; received < count && open;) {
+            long n = input.readFrom(pipeEnds[0]);
+            REQUIRE(n > 0);
+            received += static_cast<size_t>(n);
+            open = session.processLines(input, sink);
+        }
+    }
+    close(pipeEnds[0]);
+    close(pipeEnds[1]);
+    return output;
+}
+
+TEST_CASE("Client session: commands, bulk blocks and one report per batch") {
+    int reports = 0;
+    double lastWeight = -1;
+    ClientSession session([&](Graph& graph, TextSink& output) {
+        graph.Solve();
+        ++reports;
+        lastWeight = graph.getTotalWeight_MST();
+        output.write("[report]\n");
+    });
+    LineBuffer input;
+    bool open = false;
+
+    CHECK(runSession(session, input, "add 0 1 5\n", open) == "Graph not created. Use 'create' first.\n");
+    CHECK(reports == 0); // No graph, no report.
+
+    // Pipelined commands: every reply, then a single report for the state after the last one.
+    std::string output = runSession(session, input, "create 4\nadd 0 1 5\nadd 1 2 3\nfrobnicate\n", open);
+    CHECK(open);
+    CHECK(output == "Graph created with 4 vertices.\n"
+                    "Edge added: (0, 1) with weight 5\n"
+                    "Edge added: (1, 2) with weight 3\n"
+                    "Unknown command. Use 'help' for a list of commands.\n"
+                    "[report]\n");
+    CHECK(reports == 1);
+    CHECK(lastWeight == 0); // Vertex 3 is not connected yet: no spanning tree.
+
+    // A bulk block split in the middle of a line: nothing is applied or reported until it is complete.
+    output = runSession(session, input, "bulk_add 3\n2 3 1\n0 ", open, 16);
+    CHECK(output.empty());
+    CHECK(reports == 1);
+    output = runSession(session, input, "3 9\n0 2 20\n", open);
+    CHECK(output == "Edges added: 3\n[report]\n");
+    CHECK(reports == 2);
+    CHECK(lastWeight == 9);
+
+    // A malformed line spoils the whole block, which is still consumed to its end.
+    output = runSession(session, input, "bulk_add 2\n1 3 x\n0 2 1\nremove 0 1\n", open);
+    CHECK(output == "Invalid edge block. Syntax: 'bulk_add <count>' followed by <count> lines 'u v w'\n"
+                    "Edge removed: (0, 1)\n"
+                    "[report]\n");
+    CHECK(lastWeight == 13);
+
+    std::string tooLong(LineBuffer::MAX_LINE_LENGTH + 1, 'z');
+    output = runSession(session, input, tooLong + "\n", open, 65536);
+    CHECK(output == "Error: Command too long (max " + std::to_string(LineBuffer::MAX_LINE_LENGTH) + " bytes).\n");
+
+    // `shutdown` ends the session: the commands after it are ignored and no report is sent.
+    output = runSession(session, input, "add 0 3 1\nshutdown\nadd 1 3 1\n", open);
+    CHECK_FALSE(open);
+    CHECK(output == "Edge added: (0, 3) with weight 1\nShutting down client.\n");
+    CHECK(reports == 3);
+}
+
+// Builds a binary request payload: the opcode, then `args`.
+static std::string binaryRequest(uint8_t opcode, const std::string& args = "") {
+    return std::string(1, static_cast<char>(opcode)) + args;
+}
+
+// Runs one request through `BinaryProtocol::handle`, checks the frame header of the reply and returns its body.
+static std::string binaryCall(const std::string& payload, std::shared_ptr<Graph>& graph, uint8_t expectedStatus) {
+    std::string frame = BinaryProtocol::handle(payload.data(), static_cast<uint32_t>(payload.size()), graph);
+    REQUIRE(frame.size() >= 6);
+    CHECK(BinaryProtocol::getU32(frame.data()) == frame.size() - 4);
+    CHECK(static_cast<uint8_t>(frame[4]) == expectedStatus);
+    CHECK(static_cast<uint8_t>(frame[5]) == (payload.empty() ? 0 : static_cast<uint8_t>(payload[0])));
+    return frame.substr(6);
+}
+
+TEST_CASE("Binary protocol: framing") {
+    CHECK(BinaryProtocol::isHandshake("MSTB", 4));
+    CHECK_FALSE(BinaryProtocol::isHandshake("MST", 3));
+    CHECK_FALSE(BinaryProtocol::isHandshake("crea", 4));
+    CHECK(BinaryProtocol::handshakeReply() == std::string("MSTB\x01", 5));
+
+    std::string encoded;
+    BinaryProtocol::putU32(encoded, 0x01020304u);
+    BinaryProtocol::putI32(encoded, -2);
+    BinaryProtocol::putF64(encoded, 2.5);
+    REQUIRE(encoded.size() == 16);
+    CHECK(encoded.substr(0, 4) == std::string("\x04\x03\x02\x01", 4)); // Little-endian.
+    CHECK(BinaryProtocol::getU32(encoded.data()) == 0x01020304u);
+    CHECK(BinaryProtocol::getI32(encoded.data() + 4) == -2);
+    CHECK(BinaryProtocol::getF64(encoded.data() + 8) == 2.5);
+
+    std::string frame;
+    BinaryProtocol::putU32(frame, 3);
+    frame += "abc";
+    uint32_t length = 0;
+    CHECK(BinaryProtocol::peekFrame(frame.data(), 2, length) == BinaryProtocol::FrameStatus::Incomplete);
+    CHECK(BinaryProtocol::peekFrame(frame.data(), 6, length) == BinaryProtocol::FrameStatus::Incomplete);
+    CHECK(length == 3);
+    CHECK(BinaryProtocol::peekFrame(frame.data(), frame.size(), length) == BinaryProtocol::FrameStatus::Complete);
+    std::string empty;
+    BinaryProtocol::putU32(empty, 0);
+    CHECK(BinaryProtocol::peekFrame(empty.data(), empty.size(), length) == BinaryProtocol::FrameStatus::Complete);
+    CHECK(length == 0);
+    std::string huge;
+    BinaryProtocol::putU32(huge, BinaryProtocol::MAX_FRAME_SIZE + 1);
+    CHECK(BinaryProtocol::peekFrame(huge.data(), huge.size(), length) == BinaryProtocol::FrameStatus::TooLarge);
+    CHECK(static_cast<uint8_t>(BinaryProtocol::frameTooLarge()[4]) == BinaryProtocol::ERROR);
+}
+
+TEST_CASE("Binary protocol: request round trip") {
+    std::shared_ptr<Graph> graph;
+    CHECK(binaryCall("", graph, BinaryProtocol::ERROR) == "Empty frame.");
+    binaryCall(binaryRequest(BinaryProtocol::SOLVE), graph, BinaryProtocol::ERROR); // No graph yet.
+
+    std::string args;
+    BinaryProtocol::putI32(args, 4);
+    CHECK(binaryCall(binaryRequest(BinaryProtocol::CREATE, args), graph, BinaryProtocol::OK).empty());
+    REQUIRE(graph);
+    CHECK(graph->getNumVertices() == 4);
+
+    args.clear();
+    for (int32_t value : {0, 1, 5}) BinaryProtocol::putI32(args, value);
+    CHECK(binaryCall(binaryRequest(BinaryProtocol::ADD, args), graph, BinaryProtocol::OK).empty());
+    args.clear();
+    for (int32_t value : {0, 9, 5}) BinaryProtocol::putI32(args, value);
+    binaryCall(binaryRequest(BinaryProtocol::ADD, args), graph, BinaryProtocol::ERROR); // Invalid vertex.
+
+    // Three edges, one of them with an invalid vertex: two are applied.
+    args.clear();
+    BinaryProtocol::putU32(args, 3);
+    for (int32_t value : {1, 2, 3, 2, 3, 1, 3, 7, 1}) BinaryProtocol::putI32(args, value);
+    std::string body = binaryCall(binaryRequest(BinaryProtocol::BULK_ADD, args), graph, BinaryProtocol::OK);
+    REQUIRE(body.size() == 4);
+    CHECK(BinaryProtocol::getU32(body.data()) == 2);
+
+    // A count that does not match the payload is rejected without touching the graph.
+    args.clear();
+    BinaryProtocol::putU32(args, 2);
+    for (int32_t value : {0, 2, 1}) BinaryProtocol::putI32(args, value);
+    binaryCall(binaryRequest(BinaryProtocol::BULK_ADD, args), graph, BinaryProtocol::ERROR);
+    CHECK_FALSE(graph->hasEdge(0, 2));
+
+    body = binaryCall(binaryRequest(BinaryProtocol::SOLVE), graph, BinaryProtocol::OK);
+    REQUIRE(body.size() == 48 + 3 * 12);
+    CHECK(BinaryProtocol::getI32(body.data()) == 4);        // mstVertices
+    CHECK(BinaryProtocol::getI32(body.data() + 4) == 3);    // mstEdges
+    CHECK(BinaryProtocol::getF64(body.data() + 8) == 9.0);  // totalWeight
+    CHECK(BinaryProtocol::getF64(body.data() + 16) == doctest::Approx(graph->getAverageDistance_MST()));
+    const char* heaviest = body.data() + 24;
+    CHECK(BinaryProtocol::getI32(heaviest) == 0);
+    CHECK(BinaryProtocol::getI32(heaviest + 4) == 1);
+    CHECK(BinaryProtocol::getI32(heaviest + 8) == 5);
+    const char* lightest = body.data() + 36;
+    CHECK(BinaryProtocol::getI32(lightest + 8) == 1);
+    std::set<std::array<int, 3>> edges;
+    for (int i = 0; i < 3; ++i) {
+        const char* edge = body.data() + 48 + 12 * i;
+        edges.insert({BinaryProtocol::getI32(edge), BinaryProtocol::getI32(edge + 4), BinaryProtocol::getI32(edge + 8)});
+    }
+    CHECK(edges == std::set<std::array<int, 3>>{{0, 1, 5}, {1, 2, 3}, {2, 3, 1}});
+
+    // The extremes are the text report's, including its conventions for an MST without positive weights.
+    args.clear();
+    BinaryProtocol::putI32(args, 3);
+    binaryCall(binaryRequest(BinaryProtocol::CREATE, args), graph, BinaryProtocol::OK);
+    for (int32_t weight : {-4, -2}) {
+        args.clear();
+        for (int32_t value : {weight == -4 ? 0 : 1, weight == -4 ? 1 : 2, weight}) BinaryProtocol::putI32(args, value);
+        binaryCall(binaryRequest(BinaryProtocol::ADD, args), graph, BinaryProtocol::OK);
+    }
+    body = binaryCall(binaryRequest(BinaryProtocol::SOLVE), graph, BinaryProtocol::OK);
+    REQUIRE(body.size() == 48 + 2 * 12);
+    const MSTResult& result = graph->analyzeMST();
+    CHECK(BinaryProtocol::getI32(body.data() + 24) == result.heaviestEdge.u);
+    CHECK(BinaryProtocol::getI32(body.data() + 24) == -1);
+    CHECK(BinaryProtocol::getI32(body.data() + 32) == result.heaviestEdge.weight);
+    CHECK(BinaryProtocol::getI32(body.data() + 36) == result.lightestEdge.u);
+    CHECK(BinaryProtocol::getI32(body.data() + 40) == result.lightestEdge.v);
+    CHECK(BinaryProtocol::getI32(body.data() + 44) == -4);
+
+    CHECK(binaryCall(binaryRequest(0x7F), graph, BinaryProtocol::ERROR) == "Unknown opcode.");
+    CHECK(binaryCall(binaryRequest(BinaryProtocol::SHUTDOWN), graph, BinaryProtocol::OK).empty());
+}
+
 // TEST_CASE("BIG TESTS") {
 // // --- Test graph with 3 vertices ---
 // Graph graph3(3);
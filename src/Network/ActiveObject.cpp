@@ -1,9 +1,11 @@
 #include "ActiveObject.hpp" // Includes the header file containing the declaration of the ActiveObject class
+#include <chrono>           // Measures the time spent executing tasks
 
 // Constructor of the ActiveObject class
-ActiveObject::ActiveObject() : running(false), processing(false) {
-    // Initializes the atomic variables `running` and `processing` to `false`.
-    // This indicates that the object is not active yet and no tasks are being processed.
+ActiveObject::ActiveObject(size_t capacity)
+    : taskQueue(capacity == 0 ? DEFAULT_CAPACITY : capacity), executedTasks(0), busyNanoseconds(0), running(false) {
+    // Initializes the atomic variable `running` to `false`.
+    // This indicates that the object is not active yet.
 }
 
 // Destructor of the ActiveObject class
@@ -12,12 +14,19 @@ ActiveObject::~ActiveObject() {
 }
 
 // Method to add a task to the queue
-void ActiveObject::enqueue(std::function<void()> task) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex); // Locks access to the queue to avoid race conditions.
-        taskQueue.push(std::move(task)); // Safely adds the task to the queue.
-    }
-    condition.notify_one(); // Notifies the worker thread that a new task is available.
+void ActiveObject::enqueue(Task task) {
+    // Claims a slot without locking; sleeps only while the queue is full.
+    // Wakes the worker thread only if it is parked waiting for a task.
+    taskQueue.push(std::move(task));
+}
+
+// Throughput counters
+uint64_t ActiveObject::tasksExecuted() const {
+    return executedTasks.load(std::memory_order_relaxed);
+}
+
+uint64_t ActiveObject::busyTimeNanoseconds() const {
+    return busyNanoseconds.load(std::memory_order_relaxed);
 }
 
 // Method to start the active object
@@ -28,17 +37,13 @@ void ActiveObject::start() {
 
 // Method to stop the active object
 void ActiveObject::stop() {
-    {
-        std::unique_lock<std::mutex> lock(queueMutex); // Locks access to the queue.
-        running = false; // Marks the object as inactive, preventing new tasks from being accepted.
-        condition.notify_all(); // Wakes up the worker thread to allow it to exit the execution loop.
-
-        // Waits until all pending tasks are completed before terminating.
-        condition.wait(lock, [this]() {
-            return taskQueue.empty() && !processing; // Waits if there are still tasks being processed.
-        });
+    if (!running.exchange(false)) {
+        return; // Never started, or already stopped.
     }
 
+    // Closing the queue lets the worker thread finish the pending tasks, then leave `run`.
+    taskQueue.close();
+
     // Joins the worker thread to ensure it has finished before stopping.
     if (workerThread.joinable()) {
         workerThread.join(); // Properly terminates the thread after processing all tasks.
@@ -47,38 +52,18 @@ void ActiveObject::stop() {
 
 // Main function executed by the worker thread
 void ActiveObject::run() {
-    // Continues as long as `running` is true or there are tasks in the queue.
-    while (running || !taskQueue.empty()) {
-        std::function<void()> task; // Variable to store the task to execute.
-        {
-            std::unique_lock<std::mutex> lock(queueMutex); // Locks access to the queue.
-            condition.wait(lock, [this]() {
-                // Waits for a task to become available or for the object to stop.
-                return !taskQueue.empty() || !running;
-            });
-
-            // If the object is no longer active (`running` is false) and the queue is empty, exit the loop.
-            if (!running && taskQueue.empty())
-                break;
-
-            // Retrieves the task at the front of the queue and removes it from the queue.
-            task = std::move(taskQueue.front());
-            taskQueue.pop();
-            processing = true; // Marks that a task is being processed.
-        }
+    Task task; // Variable to store the task to execute.
 
+    // Waits for each task in turn; `pop` returns false once the queue is closed and empty.
+    while (taskQueue.pop(task)) {
         // Executes the task if it is valid.
         if (task) {
-            task(); // Calls the encapsulated task in the std::function.
-        }
-
-        // Checks if all tasks are completed.
-        {
-            std::lock_guard<std::mutex> lock(queueMutex); // Locks access to the queue.
-            if (taskQueue.empty()) {    // If the queue is empty.
-                processing = false;     // Marks that there are no tasks being processed.
-                condition.notify_all(); // Notifies waiting threads that all tasks are finished.
-            }
+            auto begin = std::chrono::steady_clock::now();
+            task(); // Calls the encapsulated task.
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+            busyNanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+            executedTasks.fetch_add(1, std::memory_order_relaxed);
         }
+        task = nullptr; // Releases the task's captures before waiting for the next one.
     }
-}
\ No newline at end of file
+}
@@ -5,26 +5,25 @@
 // If the symbol `ACTIVEOBJECT_HPP` is not defined, define it now.
 // Ensures that this file is included only once in each compilation unit.
 
-#include <queue>                  // Used to manage the task queue (std::queue).
 #include <thread>                 // Provides std::thread for thread management.
-#include <mutex>                  // Provides std::mutex to protect shared resources.
-#include <condition_variable>     // Provides std::condition_variable for thread synchronization.
-#include <functional>             // Provides std::function to encapsulate tasks.
 #include <atomic>                 // Provides std::atomic for thread-safe variables.
+#include <cstddef>                // Provides size_t for the queue capacity.
+#include <cstdint>                // Provides uint64_t for the throughput counters.
+#include "MPSCQueue.hpp"          // Lock-free task queue with futex parking.
+#include "Task.hpp"               // Move-only task with inline storage.
 
 // Declaration of the `ActiveObject` class
 class ActiveObject {
 private:
-    std::queue<std::function<void()>> taskQueue; // Queue to store tasks to be executed.
-                                                 // Each task is encapsulated in std::function<void()>,
-                                                 // allowing any compatible function or lambda to be managed.
+    MPSCQueue<Task> taskQueue;                  // Queue to store tasks to be executed.
+                                                 // Each task is a move-only Task stored in its ring slot,
+                                                 // so a small lambda is queued without any allocation.
+                                                 // Producers claim slots with a single atomic operation and
+                                                 // the worker thread sleeps on a futex while it is empty,
+                                                 // so submitting a task takes no lock.
 
-    std::mutex queueMutex;                      // Mutex to protect concurrent access to the task queue.
-                                                 // Prevents race conditions when multiple threads
-                                                 // add or remove tasks simultaneously.
-
-    std::condition_variable condition;          // Condition variable to pause and wake up the worker thread.
-                                                 // Used to avoid busy waiting (active spinning).
+    std::atomic<uint64_t> executedTasks;        // Number of tasks executed so far.
+    std::atomic<uint64_t> busyNanoseconds;      // Total time spent executing tasks.
 
     std::thread workerThread;                   // Dedicated thread to execute tasks.
                                                  // Fetches tasks from the queue and executes them.
@@ -33,18 +32,23 @@ private:
                                                  // Used to control the lifecycle of the worker thread
                                                  // in a thread-safe manner.
 
-    std::atomic<bool> processing;               // Indicates whether a task is currently being processed.
-                                                 // Helps determine if the thread is busy.
-
     void run();                                  // Main private method executed by the worker thread.
                                                  // Contains the task processing loop.
 
 public:
-    ActiveObject();                              // Constructor: Initializes control variables (running, processing).
+    static constexpr size_t DEFAULT_CAPACITY = 1024; // Queue capacity used when none is given.
+
+    explicit ActiveObject(size_t capacity = 0);  // Constructor: Initializes control variables (running)
+                                                 // and the queue capacity (0 = DEFAULT_CAPACITY).
     ~ActiveObject();                             // Destructor: Stops the worker thread gracefully if it is still active.
 
-    void enqueue(std::function<void()> task);    // Method to add a task to the queue.
-                                                 // A task is encapsulated in std::function<void()>.
+    void enqueue(Task task);                     // Method to add a task to the queue.
+                                                 // Any callable is accepted and moved into a Task.
+                                                 // Blocks while the queue is full, which applies
+                                                 // back-pressure to the producers.
+
+    uint64_t tasksExecuted() const;              // Number of tasks executed so far (throughput counter).
+    uint64_t busyTimeNanoseconds() const;        // Total time the worker thread spent executing tasks.
 
     void start();                                // Method to start the active object.
                                                  // Launches the worker thread and begins task processing.
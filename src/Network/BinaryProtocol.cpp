@@ -0,0 +1,237 @@
+#include "BinaryProtocol.hpp"
+#include "../../src/Model/Graph.hpp"
+#include "../../src/Model/MSTFactory.hpp"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace BinaryProtocol {
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) out.push_back(static_cast<char>((value >> shift) & 0xFF));
+}
+
+void putI32(std::string& out, int32_t value) {
+    putU32(out, static_cast<uint32_t>(value));
+}
+
+void putF64(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int shift = 0; shift < 64; shift += 8) out.push_back(static_cast<char>((bits >> shift) & 0xFF));
+}
+
+uint32_t getU32(const char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) value = (value << 8) | static_cast<uint8_t>(in[i]);
+    return value;
+}
+
+int32_t getI32(const char* in) {
+    return static_cast<int32_t>(getU32(in));
+}
+
+double getF64(const char* in) {
+    uint64_t bits = 0;
+    for (int i = 7; i >= 0; --i) bits = (bits << 8) | static_cast<uint8_t>(in[i]);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool isHandshake(const char* data, size_t size) {
+    return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+std::string handshakeReply() {
+    std::string handshake(MAGIC, sizeof(MAGIC));
+    handshake.push_back(static_cast<char>(VERSION));
+    return handshake;
+}
+
+FrameStatus peekFrame(const char* data, size_t size, uint32_t& length) {
+    if (size < 4) return FrameStatus::Incomplete;
+    length = getU32(data);
+    if (length > MAX_FRAME_SIZE) return FrameStatus::TooLarge;
+    return size - 4 >= length ? FrameStatus::Complete : FrameStatus::Incomplete;
+}
+
+namespace {
+
+// Sends the whole buffer, retrying after partial writes.
+bool sendAll(int client_socket, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(client_socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Makes sure `pending` holds at least `size` bytes from `consumed` on, reading from the socket as needed.
+bool fill(int client_socket, std::string& pending, size_t consumed, size_t size) {
+    char buffer[4096];
+    while (pending.size() - consumed < size) {
+        ssize_t n = read(client_socket, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        pending.append(buffer, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+// Wraps a reply body in a frame: length, status, opcode, body.
+std::string reply(Status status, uint8_t opcode, const std::string& body = "") {
+    std::string frame;
+    frame.reserve(6 + body.size());
+    putU32(frame, static_cast<uint32_t>(2 + body.size()));
+    frame.push_back(static_cast<char>(status));
+    frame.push_back(static_cast<char>(opcode));
+    frame += body;
+    return frame;
+}
+
+std::string error(uint8_t opcode, const std::string& message) {
+    return reply(ERROR, opcode, message);
+}
+
+// Solves the MST and packs the SolveSummary and the edge list, straight from the numeric `MSTResult`.
+std::string solveReply(Graph& graph) {
+    graph.Solve();
+    const MSTResult& result = graph.analyzeMST();
+
+    SolveSummary summary{};
+    summary.mstVertices = result.vertices;
+    summary.mstEdges = static_cast<int32_t>(result.edges.size());
+    summary.totalWeight = result.totalWeight;
+    summary.averageDistance = result.averageDistance;
+    // The same extremes as the text report, with its conventions for ties and for an MST without edges.
+    summary.heaviestU = result.heaviestEdge.u;
+    summary.heaviestV = result.heaviestEdge.v;
+    summary.heaviestWeight = result.heaviestEdge.weight;
+    summary.lightestU = result.lightestEdge.u;
+    summary.lightestV = result.lightestEdge.v;
+    summary.lightestWeight = result.lightestEdge.weight;
+    std::string edges;
+    edges.reserve(12 * static_cast<size_t>(summary.mstEdges));
+    for (const WeightedEdge& edge : result.edges) {
+        putI32(edges, edge.u);
+        putI32(edges, edge.v);
+        putI32(edges, edge.weight);
+    }
+
+    std::string body;
+    putI32(body, summary.mstVertices);
+    putI32(body, summary.mstEdges);
+    putF64(body, summary.totalWeight);
+    putF64(body, summary.averageDistance);
+    putI32(body, summary.heaviestU);
+    putI32(body, summary.heaviestV);
+    putI32(body, summary.heaviestWeight);
+    putI32(body, summary.lightestU);
+    putI32(body, summary.lightestV);
+    putI32(body, summary.lightestWeight);
+    body += edges;
+    return reply(OK, SOLVE, body);
+}
+
+} // namespace
+
+std::string handle(const char* payload, uint32_t size, std::shared_ptr<Graph>& graph) {
+    if (size == 0) return error(0, "Empty frame.");
+    uint8_t opcode = static_cast<uint8_t>(payload[0]);
+    const char* args = payload + 1;
+    uint32_t argsSize = size - 1;
+
+    if (opcode == CREATE) {
+        if (argsSize != 4) return error(opcode, "CREATE expects int32 vertices.");
+        int32_t vertices = getI32(args);
+        if (vertices <= 0) return error(opcode, "Number of vertices must be > 0.");
+        graph = std::make_shared<Graph>(vertices);
+        graph->setDynamicMST(true);
+        return reply(OK, opcode);
+    }
+    if (opcode != SHUTDOWN && !graph) return error(opcode, "Graph not created. Use CREATE first.");
+
+    switch (opcode) {
+        case ADD: {
+            if (argsSize != 12) return error(opcode, "ADD expects int32 u, v, w.");
+            int32_t u = getI32(args), v = getI32(args + 4);
+            if (!graph->isValidVertex(u) || !graph->isValidVertex(v)) return error(opcode, "Invalid vertex.");
+            graph->add_edge(u, v, getI32(args + 8));
+            return reply(OK, opcode);
+        }
+        case REMOVE: {
+            if (argsSize != 8) return error(opcode, "REMOVE expects int32 u, v.");
+            graph->remove_edge(getI32(args), getI32(args + 4));
+            return reply(OK, opcode);
+        }
+        case ALGO: {
+            std::string name(args, argsSize);
+            if (!MSTFactory::create(name)) return error(opcode, "Unknown algorithm '" + name + "'.");
+            graph->setAlgorithm(name);
+            return reply(OK, opcode);
+        }
+        case BULK_ADD: {
+            if (argsSize < 4) return error(opcode, "BULK_ADD expects uint32 count.");
+            uint32_t count = getU32(args);
+            if (argsSize != 4 + 12ull * count) return error(opcode, "BULK_ADD payload does not match its count.");
+            std::vector<WeightedEdge> edges(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                const char* edge = args + 4 + 12 * static_cast<size_t>(i);
+                edges[i] = {getI32(edge), getI32(edge + 4), getI32(edge + 8)};
+            }
+            std::string body;
+            putU32(body, static_cast<uint32_t>(graph->add_edges(edges)));
+            return reply(OK, opcode, body);
+        }
+        case SOLVE:
+            return solveReply(*graph);
+        case SHUTDOWN:
+            return reply(OK, opcode);
+        default:
+            return error(opcode, "Unknown opcode.");
+    }
+}
+
+std::string frameTooLarge() {
+    return error(0, "Frame too large.");
+}
+
+Outcome serve(int client_socket, std::string pending, const std::atomic<bool>& running) {
+    if (!sendAll(client_socket, handshakeReply())) return Outcome::Disconnected;
+
+    std::shared_ptr<Graph> graph;
+    size_t consumed = 0; // Bytes of `pending` already handled; compacted once they make up most of it.
+    while (running) {
+        if (consumed > 0 && consumed * 2 >= pending.size()) {
+            pending.erase(0, consumed);
+            consumed = 0;
+        }
+        uint32_t length = 0;
+        FrameStatus status;
+        while ((status = peekFrame(pending.data() + consumed, pending.size() - consumed, length)) == FrameStatus::Incomplete) {
+            size_t needed = pending.size() - consumed < 4 ? 4 : 4 + static_cast<size_t>(length);
+            if (!fill(client_socket, pending, consumed, needed)) return Outcome::Disconnected;
+        }
+        if (status == FrameStatus::TooLarge) {
+            sendAll(client_socket, frameTooLarge());
+            return Outcome::Disconnected;
+        }
+
+        const char* payload = pending.data() + consumed + 4;
+        uint8_t opcode = length > 0 ? static_cast<uint8_t>(payload[0]) : 0;
+        std::string response = handle(payload, length, graph);
+        consumed += 4 + static_cast<size_t>(length);
+        if (!sendAll(client_socket, response)) return Outcome::Disconnected;
+        if (opcode == SHUTDOWN) return Outcome::Shutdown;
+    }
+    return Outcome::Disconnected;
+}
+
+} // namespace BinaryProtocol
@@ -0,0 +1,131 @@
+#ifndef BINARYPROTOCOL_HPP
+#define BINARYPROTOCOL_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+class Graph;
+
+/**
+ * @namespace BinaryProtocol
+ * @brief Length-prefixed binary alternative to the text command interface.
+ *
+ * A client switches its connection to binary mode by sending the 4 bytes `MAGIC` ("MSTB") as the very first bytes
+ * of the connection. The server answers with `MAGIC` followed by one `VERSION` byte; since the text help menu has
+ * already been sent at that point, a binary client discards everything up to and including the first "MSTB".
+ *
+ * From then on, every message in both directions is a frame, and all integers are little-endian:
+ *
+ *     uint32 length | payload (`length` bytes)
+ *
+ * Request payloads start with a one-byte opcode:
+ *     CREATE   int32 vertices
+ *     ADD      int32 u, int32 v, int32 w
+ *     REMOVE   int32 u, int32 v
+ *     ALGO     the algorithm name (the rest of the payload, as in the text `algo` command)
+ *     BULK_ADD uint32 count, then count x (int32 u, int32 v, int32 w)
+ *     SOLVE    (empty)
+ *     SHUTDOWN (empty)
+ *
+ * Reply payloads start with a status byte and the opcode they answer. An ERROR reply carries a text message.
+ * An OK reply to SOLVE carries a `SolveSummary` (packed in field order) followed by `mstEdges` x (int32 u, v, w),
+ * with u < v. Other OK replies carry no body (BULK_ADD replies with the uint32 number of edges applied).
+ * The heaviest and lightest edges are those of the text report (`MSTResult::heaviestEdge` / `lightestEdge`):
+ * the first one in CSR order wins ties, and the vertices are -1 when there is no such edge (for the heaviest,
+ * no edge of positive weight). A graph without a spanning tree yields mstVertices == 0 and no edges.
+ * Frames are read exactly, so requests may be split or coalesced across TCP segments in any way.
+ */
+namespace BinaryProtocol {
+
+const char MAGIC[4] = {'M', 'S', 'T', 'B'};
+const uint8_t VERSION = 1;
+const uint32_t MAX_FRAME_SIZE = 64u << 20; ///< Larger frames are rejected and the connection is closed.
+
+enum Opcode : uint8_t {
+    CREATE = 1,
+    ADD = 2,
+    REMOVE = 3,
+    ALGO = 4,
+    BULK_ADD = 5,
+    SOLVE = 6,
+    SHUTDOWN = 7
+};
+
+enum Status : uint8_t {
+    OK = 0,
+    ERROR = 1
+};
+
+/// Fixed-size part of a SOLVE reply.
+struct SolveSummary {
+    int32_t mstVertices;
+    int32_t mstEdges;
+    double totalWeight;
+    double averageDistance;
+    int32_t heaviestU, heaviestV, heaviestWeight;
+    int32_t lightestU, lightestV, lightestWeight;
+};
+
+/// How a binary session ended.
+enum class Outcome {
+    Disconnected, ///< The client closed the connection or sent an invalid frame.
+    Shutdown      ///< The client sent SHUTDOWN.
+};
+
+/// Result of `peekFrame()`.
+enum class FrameStatus {
+    Incomplete, ///< More bytes are needed.
+    Complete,   ///< A whole frame is buffered.
+    TooLarge    ///< The frame announces more than MAX_FRAME_SIZE bytes: the connection must be closed.
+};
+
+/**
+ * @brief Checks whether the first bytes received on a connection request binary mode.
+ */
+bool isHandshake(const char* data, size_t size);
+
+/// The server's answer to the handshake: `MAGIC` followed by the `VERSION` byte.
+std::string handshakeReply();
+
+/**
+ * @brief Checks whether `data` starts with a whole frame.
+ * @param length Receives the payload length once the 4-byte header is available.
+ */
+FrameStatus peekFrame(const char* data, size_t size, uint32_t& length);
+
+/**
+ * @brief Executes one request payload (a frame without its length) and returns the reply frame.
+ *
+ * This is the step of a session that does not touch the socket, so that an event loop can run it on frames it
+ * parsed itself. `graph` is the session's graph, created by CREATE.
+ */
+std::string handle(const char* payload, uint32_t size, std::shared_ptr<Graph>& graph);
+
+/// The error frame sent before closing a connection whose frame is too large.
+std::string frameTooLarge();
+
+/**
+ * @brief Runs a binary session on a connected blocking socket until SHUTDOWN, disconnection or server stop.
+ *
+ * Sends the handshake reply, then reads frames and answers each one with `handle()`, with a graph of its own.
+ *
+ * @param client_socket The socket descriptor for the client.
+ * @param pending Bytes already received after the magic (the start of the first frame, if any).
+ * @param running The server's running flag; the session ends when it is cleared.
+ */
+Outcome serve(int client_socket, std::string pending, const std::atomic<bool>& running);
+
+/// Little-endian encoding helpers, shared by the server and by clients/tests.
+void putU32(std::string& out, uint32_t value);
+void putI32(std::string& out, int32_t value);
+void putF64(std::string& out, double value);
+uint32_t getU32(const char* in);
+int32_t getI32(const char* in);
+double getF64(const char* in);
+
+} // namespace BinaryProtocol
+
+#endif // BINARYPROTOCOL_HPP
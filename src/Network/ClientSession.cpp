@@ -0,0 +1,177 @@
+#include "ClientSession.hpp"
+#include "../../src/Model/MSTFactory.hpp"
+#include <sstream>
+#include <iostream>
+#include <climits>
+#include <algorithm>
+
+ClientSession::ClientSession(Analyzer analyzer) : analyzer(std::move(analyzer)) {}
+
+std::string ClientSession::helpMenu() {
+    std::string helpMenu = "------------------------ COMMAND MENU --------------------------------------------\n";
+    helpMenu += "Create a new graph:\n   - Syntax: 'create <number_of_vertices>'\n";
+    helpMenu += "Add an edge:\n   - Syntax: 'add <u> <v> <w>'\n";
+    helpMenu += "Add many edges at once:\n   - Syntax: 'bulk_add <count>' followed by <count> lines 'u v w'\n";
+    helpMenu += "Remove an edge:\n   - Syntax: 'remove <u> <v>'\n";
+    helpMenu += "Choose MST Algorithm:\n   - Syntax: 'algo <algorithm_name>'\n     (auto/prim/kruskal/filter_kruskal/tarjan/boruvka/integer_mst)\n";
+    helpMenu += "Shutdown:\n   - Syntax: 'shutdown'\n";
+    helpMenu += "----------------------------------------------------------------------------------\n";
+    return helpMenu;
+}
+
+bool ClientSession::processLines(LineBuffer& input, TextSink& output) {
+    bool executed = false;
+    bool open = true;
+    std::string line;
+    LineBuffer::LineStatus status;
+    while (open && (status = input.nextLine(line)) != LineBuffer::LineStatus::None) {
+        if (status == LineBuffer::LineStatus::TooLong) {
+            output.write("Error: Command too long (max " + std::to_string(LineBuffer::MAX_LINE_LENGTH) + " bytes).\n");
+            bulkMalformed = bulkMalformed || bulkRemaining > 0;
+            continue;
+        }
+        if (bulkRemaining > 0) {
+            processBulkLine(line, output);
+            executed = true;
+            continue;
+        }
+        if (line.find_first_not_of(" \t") == std::string::npos) continue; // Blank line.
+        open = processCommand(line, output);
+        executed = true;
+    }
+
+    // One report per batch, for the state after its last command.
+    if (open && executed && graph && bulkRemaining == 0) {
+        analyzer(*graph, output);
+    }
+    return open;
+}
+
+// Parses one `u v w` line of a bulk_add block, and applies the block once it is complete.
+void ClientSession::processBulkLine(const std::string& line, TextSink& output) {
+    std::istringstream ss(line);
+    long long u, v, w;
+    std::string extra;
+    if (ss >> u >> v >> w && !(ss >> extra) && w >= INT_MIN && w <= INT_MAX &&
+        u >= INT_MIN && u <= INT_MAX && v >= INT_MIN && v <= INT_MAX) {
+        bulkEdges.push_back({static_cast<int>(u), static_cast<int>(v), static_cast<int>(w)});
+    } else {
+        bulkMalformed = true;
+    }
+    if (--bulkRemaining > 0) return;
+
+    if (bulkMalformed) {
+        output.write("Invalid edge block. Syntax: 'bulk_add <count>' followed by <count> lines 'u v w'\n");
+    } else {
+        size_t applied = graph->add_edges(bulkEdges);
+        std::string response = "Edges added: " + std::to_string(applied);
+        if (applied < bulkEdges.size()) response += " (" + std::to_string(bulkEdges.size() - applied) + " skipped: invalid vertex)";
+        output.write(response + "\n");
+    }
+    bulkEdges.clear();
+    bulkEdges.shrink_to_fit();
+    bulkMalformed = false;
+}
+
+// Executes one text command. Returns false for `shutdown`.
+bool ClientSession::processCommand(const std::string& line, TextSink& output) {
+    std::stringstream ss(line);
+    std::string command;
+    ss >> command;
+
+    if (command == "create") { // Create a graph.
+        std::string token;
+        if (ss >> token) {
+            try {
+                int size = std::stoi(token);
+                if (size <= 0) { // Vérifie si le nombre de sommets est <= 0.
+                    output.write("Error: Number of vertices must be > 0.\n"
+                                      "Try again: create <number_of_vertices>\n");
+                } else {
+                    // Vérifie s'il y a des arguments supplémentaires
+                    std::string extra;
+                    if (ss >> extra) { // Arguments supplémentaires détectés.
+                        output.write("Error: Too many arguments provided.\n"
+                                          "Syntax: create <number_of_vertices>\n"
+                                          "Example: create 5\n");
+                    } else { // Aucun argument supplémentaire, commande valide.
+                        graph = std::make_shared<Graph>(size);
+                        graph->setDynamicMST(true); // Update the MST in place on add/remove instead of rebuilding it.
+                        output.write("Graph created with " + std::to_string(size) + " vertices.\n");
+                    }
+                }
+            } catch (...) {
+                output.write("Invalid input. Syntax: create <number_of_vertices>\n"
+                                  "Example: create 5\n");
+            }
+        } else {
+            output.write("Error: Missing argument. Syntax: create <number_of_vertices>\n"
+                              "Example: create 5\n");
+        }
+    }
+    else if (command == "add") { // Add an edge.
+        if (!graph) {
+            output.write("Graph not created. Use 'create' first.\n");
+            return true;
+        }
+        int u, v, weight;
+        if (ss >> u >> v >> weight) {
+            graph->add_edge(u, v, weight);
+            output.write("Edge added: (" + std::to_string(u) + ", " + std::to_string(v) + ") with weight " + std::to_string(weight) + "\n");
+        } else {
+            output.write("Invalid input. Syntax: 'add <u> <v> <w>'\n");
+        }
+    }
+    else if (command == "bulk_add") { // Add a block of edges with a single MST update.
+        if (!graph) {
+            output.write("Graph not created. Use 'create' first.\n");
+            return true;
+        }
+        int count;
+        if (ss >> count && count > 0 && count <= MAX_BULK_EDGES) {
+            bulkRemaining = count; // The next `count` lines are the edges.
+            bulkEdges.reserve(std::min(count, 1 << 20));
+        } else {
+            output.write("Invalid input. Syntax: 'bulk_add <count>' with 0 < count <= " + std::to_string(MAX_BULK_EDGES) + "\n");
+        }
+    }
+    else if (command == "remove") { // Remove an edge.
+        if (!graph) {
+            output.write("Graph not created. Use 'create' first.\n");
+            return true;
+        }
+        int u, v;
+        if (ss >> u >> v) {
+            graph->remove_edge(u, v);
+            output.write("Edge removed: (" + std::to_string(u) + ", " + std::to_string(v) + ")\n");
+        } else {
+            output.write("Invalid input. Syntax: 'remove <u> <v>'\n");
+        }
+    }
+    else if (command == "algo") { // Set MST algorithm.
+        if (!graph) {
+            std::cerr << "Graph not initialized when trying to set algorithm." << std::endl;
+            output.write("Error: Graph not created. Use 'create' first.\n");
+            return true;
+        }
+        std::string selectedAlgorithm;
+        if (ss >> selectedAlgorithm) {
+            if (MSTFactory::create(selectedAlgorithm)) {
+                graph->setAlgorithm(selectedAlgorithm);
+                output.write("Algorithm set to " + selectedAlgorithm + ".\n");
+            } else {
+                output.write("Error: Unknown algorithm '" + selectedAlgorithm + "'.\n");
+            }
+        } else {
+            output.write("Invalid input. Syntax: 'algo <algorithm_name>'\n");
+        }
+    }
+    else if (command == "shutdown") { // Command to disconnect the client from the server
+        output.write("Shutting down client.\n");
+        return false;
+    }
+    else { // Handle unknown commands.
+        output.write("Unknown command. Use 'help' for a list of commands.\n");
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef CLIENTSESSION_HPP
+#define CLIENTSESSION_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "LineBuffer.hpp"
+#include "../../src/Model/Graph.hpp"
+
+/**
+ * @class ClientSession
+ * @brief State and command interpreter of one text-protocol connection, shared by all server modes.
+ *
+ * The session owns the client's graph. `processLines()` executes every complete command buffered in a
+ * `LineBuffer`, in order, and writes the replies to a `TextSink` instead of sending them, so that the server
+ * decides how they go out: through a `SocketWriter` (a whole batch of pipelined commands in as few sends as
+ * possible) or into a connection's pending output. After a batch that leaves a graph, the server's `Analyzer`
+ * streams the analysis once, reflecting the state after the last command of the batch.
+ *
+ * A `bulk_add <count>` command consumes the following `count` lines as `u v w` edges, even when they arrive over
+ * several reads; the edges are applied together once the block is complete.
+ */
+class ClientSession {
+public:
+    /// Writes the MST report sent after each batch (the servers differ in how they compute it).
+    using Analyzer = std::function<void(Graph&, TextSink&)>;
+
+    static constexpr int MAX_BULK_EDGES = 10000000; ///< Upper bound on the edge count of one `bulk_add` command.
+
+    explicit ClientSession(Analyzer analyzer);
+
+    /// The command menu sent when a client connects.
+    static std::string helpMenu();
+
+    /**
+     * @brief Executes every complete command in `input` and writes the replies, then the report, to `output`.
+     * @return `false` once the client sent `shutdown` (the remaining input is then ignored).
+     */
+    bool processLines(LineBuffer& input, TextSink& output);
+
+private:
+    Analyzer analyzer;
+    std::shared_ptr<Graph> graph;
+    // Pending `bulk_add` block.
+    int bulkRemaining = 0;
+    bool bulkMalformed = false;
+    std::vector<WeightedEdge> bulkEdges;
+
+    bool processCommand(const std::string& line, TextSink& output);
+    void processBulkLine(const std::string& line, TextSink& output);
+};
+
+#endif // CLIENTSESSION_HPP
@@ -0,0 +1,59 @@
+#ifndef EVENTCOUNT_HPP
+#define EVENTCOUNT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <climits>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/**
+ * @class EventCount
+ * @brief Lets threads sleep on a futex until a condition that is checked without a lock may have changed.
+ *
+ * A waiter calls `prepareWait()`, re-checks its condition, and then either `cancelWait()` or `wait(key)`. A
+ * notifier changes the state first and then calls `notify()`, which only makes a system call when somebody
+ * is registered as waiting. If the state changes between the re-check and the sleep, the epoch no longer
+ * matches `key` and the futex wait returns at once, so no wake-up is lost.
+ */
+class EventCount {
+public:
+    uint32_t prepareWait() {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        return epoch.load(std::memory_order_seq_cst);
+    }
+
+    void cancelWait() {
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wait(uint32_t key) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// Wakes every waiter.
+    void notify() {
+        wake(INT_MAX);
+    }
+
+    /// Wakes one sleeping waiter; the others registered since their `prepareWait()` still see a new epoch.
+    void notifyOne() {
+        wake(1);
+    }
+
+private:
+    void wake(int count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Orders the state change before reading `waiters`.
+        if (waiters.load(std::memory_order_relaxed) == 0) return;
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+    std::atomic<uint32_t> epoch{0};    ///< Futex word, bumped by each notification that has waiters.
+    std::atomic<uint32_t> waiters{0};  ///< Threads between `prepareWait()` and the end of `wait()`.
+};
+
+#endif // EVENTCOUNT_HPP
@@ -1,35 +1,44 @@
 #include <vector>               // For std::vector to manage threads
-#include <queue>                // For std::queue to handle the task queue
 #include <thread>               // For std::thread to create and manage threads
 #include <mutex>                // For std::mutex to ensure thread synchronization
 #include <condition_variable>   // For std::condition_variable to notify threads
 #include <atomic>               // For std::atomic to handle atomic operations
-#include <functional>           // For std::function to represent tasks
+#include <functional>           // For std::function to represent event handlers
+#include <cstdint>              // For uint32_t event masks
 
 /**
  * @class LeaderFollowers
- * @brief Implements the "Leader/Followers" thread management pattern.
+ * @brief Implements the "Leader/Followers" thread management pattern over an epoll demultiplexing handle.
  *
- * This pattern dynamically assigns roles to threads:
- * - One thread becomes the "leader" to execute a task, while others
- *   remain idle ("followers"). When the leader is done, another thread
- *   takes over as the leader.
+ * The pool owns one epoll instance holding every registered handle (the listening socket and the client
+ * sockets). At any time exactly one thread, the "leader", waits in `epoll_wait` on it; the other threads are
+ * "followers" waiting for the leadership. When an event arrives the leader promotes a follower to be the new
+ * leader, then processes the event itself: there is no queue and no hand-off between a demultiplexing thread and
+ * a worker thread, so an event costs no extra context switch.
+ *
+ * Handles are registered with EPOLLONESHOT: a handle that reported an event stays disabled until
+ * `reactivate_handle()` is called by the thread processing it, so the new leader never receives a second event
+ * for a handle that is still being processed.
  */
 class LeaderFollowers {
 public:
-    using Task = std::function<void()>;      // Alias for a task: a function with no arguments or return value.
+    using EventHandler = std::function<void(int fd, uint32_t events)>; // Processes one event of a handle.
 
-    std::queue<Task>         _task_queue;    // Queue to hold tasks waiting to be executed.
     std::vector<std::thread> _threads;       // Vector holding all the threads in the pool.
-    std::mutex               _queue_mutex;   // Mutex to protect access to the task queue.
-    std::condition_variable  _cv;            // Condition variable to synchronize threads and signal when tasks are available.
+    std::mutex               _leader_mutex;  // Mutex protecting the leadership hand-over.
+    std::condition_variable  _cv;            // Condition variable on which followers wait for the leadership.
+    std::condition_variable  _stopped_cv;    // Condition variable on which `wait()` waits for `stop()`.
     std::atomic<bool>        _running;       // Flag indicating whether the thread pool is running or stopped.
-    std::atomic<bool>        _leader_active; // Flag indicating if a thread is currently acting as the leader.
+    bool                     _leader_active; // Flag indicating if a thread is currently acting as the leader.
     std::mutex               _log_mutex;     // Mutex to protect console/log outputs from concurrent access.
+    int                      _num_threads;   // Number of threads started by `start()`.
+    int                      _epoll_fd;      // The demultiplexing handle shared by all threads.
+    int                      _wake_fd;       // eventfd signalled by `stop()` to release the leader.
+    EventHandler             _handler;       // Called by the leader for each event, after promoting a follower.
 
     /**
      * @brief Constructor.
-     * Initializes the thread pool with the specified number of threads.
+     * Creates the demultiplexing handle; the threads are created by `start()`.
      *
      * @param num_threads Number of threads to create in the pool.
      */
@@ -42,26 +51,57 @@ public:
     ~LeaderFollowers();
 
     /**
-     * @brief Adds a task to the task queue.
+     * @brief Starts the threads; each event of a registered handle is passed to `handler`.
+     */
+    void start(const EventHandler& handler);
+
+    /**
+     * @brief Registers a handle for input events (one-shot).
      *
-     * This method is thread-safe due to the use of a mutex (`std::mutex`).
+     * @param fd The handle.
+     * @param writable Also wait for the handle to become writable (pending output).
+     * @return `false` if the handle could not be registered.
+     */
+    bool add_handle(int fd, bool writable = false);
+
+    /**
+     * @brief Re-enables a handle after its event has been processed.
      *
-     * @param task The task to add to the queue.
+     * @param fd The handle.
+     * @param writable Wait for the handle to become writable (pending output).
+     * @param readable Wait for input (cleared while output is pending, so that input waits for the output).
      */
-    void add_task(const Task& task);
+    void reactivate_handle(int fd, bool writable = false, bool readable = true);
+
+    /**
+     * @brief Unregisters a handle (before closing it).
+     */
+    void remove_handle(int fd);
+
+    /**
+     * @brief Blocks the calling thread until `stop()` is called.
+     */
+    void wait();
 
     /**
      * @brief Stops the thread pool.
      *
-     * This method signals all threads to exit their main loop, effectively shutting down the pool.
+     * Releases the leader and the followers without waiting for them, so it may be called from a pool thread
+     * (e.g. by an event handler). The threads are joined by `join()`.
      */
     void stop();
 
+    /**
+     * @brief Waits for the threads to finish, after `stop()`.
+     *
+     * Must be called from a thread outside the pool: two pool threads joining each other would deadlock.
+     */
+    void join();
+
     /**
      * @brief Main loop executed by each thread.
      *
-     * Each thread attempts to become the "leader" to execute tasks.
-     * Threads that are not leaders remain idle until a task becomes available.
+     * Each thread waits to become the leader, waits for one event, promotes a follower and processes the event.
      */
     void worker_loop();
-};
\ No newline at end of file
+};
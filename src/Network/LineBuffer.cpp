@@ -0,0 +1,77 @@
+#include "LineBuffer.hpp"
+#include <algorithm>
+#include <sys/uio.h>
+
+LineBuffer::LineBuffer() : ring(INITIAL_CAPACITY), head(0), tail(0), scanned(0), discarding(false) {}
+
+char LineBuffer::at(uint64_t offset) const {
+    return ring[offset & (ring.size() - 1)];
+}
+
+size_t LineBuffer::size() const {
+    return static_cast<size_t>(tail - head);
+}
+
+// Doubles the ring, unwrapping the buffered bytes to the start of the new storage.
+void LineBuffer::grow() {
+    std::vector<char> bigger(ring.size() * 2);
+    for (uint64_t offset = head; offset < tail; ++offset) {
+        bigger[offset & (bigger.size() - 1)] = at(offset);
+    }
+    ring.swap(bigger);
+}
+
+long LineBuffer::readFrom(int fd) {
+    if (size() == ring.size()) {
+        if (ring.size() <= MAX_LINE_LENGTH) {
+            grow();
+        } else {
+            // The buffered partial line is already too long: drop it and skip to its end.
+            head = tail = scanned;
+            discarding = true;
+        }
+    }
+
+    // The free region starts at `tail` and may wrap around the end of the ring.
+    size_t mask = ring.size() - 1;
+    size_t start = static_cast<size_t>(tail & mask);
+    size_t free = ring.size() - size();
+    size_t first = std::min(free, ring.size() - start);
+    iovec regions[2] = {{ring.data() + start, first}, {ring.data(), free - first}};
+    ssize_t n = readv(fd, regions, free > first ? 2 : 1);
+    if (n > 0) tail += static_cast<uint64_t>(n);
+    return static_cast<long>(n);
+}
+
+LineBuffer::LineStatus LineBuffer::nextLine(std::string& line) {
+    while (scanned < tail && at(scanned) != '\n') ++scanned;
+    if (scanned == tail) {
+        if (discarding) head = scanned; // Nothing of an oversized line is kept.
+        return LineStatus::None;
+    }
+
+    uint64_t end = scanned;  // Offset of the newline.
+    bool tooLong = discarding || end - head > MAX_LINE_LENGTH;
+    line.clear();
+    if (!tooLong) {
+        uint64_t last = end;
+        if (last > head && at(last - 1) == '\r') --last;
+        line.reserve(static_cast<size_t>(last - head));
+        for (uint64_t offset = head; offset < last; ++offset) line.push_back(at(offset));
+    }
+    head = scanned = end + 1;
+    discarding = false;
+    return tooLong ? LineStatus::TooLong : LineStatus::Line;
+}
+
+void LineBuffer::peek(char* out, size_t count) const {
+    for (size_t i = 0; i < count; ++i) out[i] = at(head + i);
+}
+
+std::string LineBuffer::takeAll() {
+    std::string bytes;
+    bytes.reserve(size());
+    for (uint64_t offset = head; offset < tail; ++offset) bytes.push_back(at(offset));
+    head = scanned = tail;
+    return bytes;
+}
@@ -0,0 +1,64 @@
+#ifndef LINEBUFFER_HPP
+#define LINEBUFFER_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LineBuffer
+ * @brief Per-connection receive buffer that splits a TCP byte stream into newline-delimited commands.
+ *
+ * TCP does not preserve message boundaries: one read may carry several pipelined commands, or only part of one.
+ * The buffer is a ring of `capacity` bytes: `readFrom()` appends whatever the socket has (with one `readv` into
+ * the free region, which may wrap around the end), and `nextLine()` hands out every complete line, in order,
+ * keeping a trailing partial line for the next read. The ring doubles when a line does not fit, up to
+ * `MAX_LINE_LENGTH`; a longer line is dropped and reported as `TooLong`.
+ */
+class LineBuffer {
+public:
+    static constexpr size_t INITIAL_CAPACITY = 4096;
+    static constexpr size_t MAX_LINE_LENGTH = 1 << 20;
+
+    /// Result of `nextLine()`.
+    enum class LineStatus {
+        None,    ///< No complete line is buffered.
+        Line,    ///< `line` holds the next command (without the newline and a trailing '\r').
+        TooLong  ///< A line longer than MAX_LINE_LENGTH was dropped.
+    };
+
+    LineBuffer();
+
+    /**
+     * @brief Reads once from `fd` into the free part of the ring.
+     * @return The number of bytes read, 0 on end of stream, or -1 on error.
+     */
+    long readFrom(int fd);
+
+    /**
+     * @brief Extracts the next complete line.
+     */
+    LineStatus nextLine(std::string& line);
+
+    /// Number of buffered bytes (including a partial line).
+    size_t size() const;
+
+    /// Copies the first `count` buffered bytes into `out` without consuming them (`count` <= size()).
+    void peek(char* out, size_t count) const;
+
+    /// Removes and returns all buffered bytes.
+    std::string takeAll();
+
+private:
+    std::vector<char> ring;  ///< Power-of-two sized storage.
+    uint64_t head;           ///< Stream offset of the first buffered byte.
+    uint64_t tail;           ///< Stream offset one past the last buffered byte.
+    uint64_t scanned;        ///< Bytes before this offset are known to contain no newline.
+    bool discarding;         ///< Dropping the rest of a line that exceeded MAX_LINE_LENGTH.
+
+    char at(uint64_t offset) const;
+    void grow();
+};
+
+#endif // LINEBUFFER_HPP
@@ -0,0 +1,132 @@
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+#include <atomic>        // Slot sequence numbers, cursors and futex words.
+#include <memory>        // std::unique_ptr for the slot array.
+#include <cstddef>
+#include <cstdint>
+#include "EventCount.hpp"  // Futex parking for the consumer and for producers of a full queue.
+
+/**
+ * @class MPSCQueue
+ * @brief Bounded lock-free multi-producer/single-consumer queue with futex parking.
+ *
+ * The queue is a power-of-two ring of slots, each with a sequence number (Vyukov's bounded queue): a producer
+ * claims a position with one compare-and-swap on `tail` and publishes its value by advancing the slot's
+ * sequence; the single consumer reads `head` without any atomic read-modify-write. Producers never block each
+ * other while the queue has room. A consumer finding the queue empty, or a producer finding it full, sleeps
+ * on an `EventCount` futex, so an idle queue costs no CPU and a busy one makes no system calls.
+ *
+ * @tparam T Default-constructible, move-assignable element type.
+ */
+template <typename T>
+class MPSCQueue {
+public:
+    /// @param capacity Maximum number of queued elements, rounded up to a power of two.
+    explicit MPSCQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+        mask = size - 1;
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Appends `value` if the queue has room (any thread).
+     * @return `false` if the queue is full; `value` is then left untouched.
+     */
+    bool tryPush(T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[position & mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (difference < 0) {
+                return false; // The slot still holds the element from one lap ago.
+            } else {
+                position = tail.load(std::memory_order_relaxed); // Another producer claimed it.
+            }
+        }
+        slot->value = std::move(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        notEmpty.notify();
+        return true;
+    }
+
+    /// Appends `value`, sleeping while the queue is full (any thread).
+    void push(T value) {
+        while (!tryPush(value)) {
+            uint32_t key = notFull.prepareWait();
+            if (tryPush(value)) {
+                notFull.cancelWait();
+                return;
+            }
+            notFull.wait(key);
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element into `out` (consumer thread only).
+     * @return `false` if the queue is empty.
+     */
+    bool tryPop(T& out) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) return false;
+        out = std::move(slot.value);
+        slot.value = T(); // Releases what the element owns now rather than one lap later.
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        notFull.notify();
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element into `out`, sleeping while the queue is empty (consumer thread only).
+     * @return `false` once the queue is closed and drained.
+     */
+    bool pop(T& out) {
+        while (!tryPop(out)) {
+            uint32_t key = notEmpty.prepareWait();
+            if (tryPop(out)) {
+                notEmpty.cancelWait();
+                return true;
+            }
+            if (closed.load(std::memory_order_acquire)) {
+                notEmpty.cancelWait();
+                return tryPop(out);
+            }
+            notEmpty.wait(key);
+        }
+        return true;
+    }
+
+    /// Makes `pop` return `false` once the queue is drained. Elements pushed before `close` are still delivered.
+    void close() {
+        closed.store(true, std::memory_order_release);
+        notEmpty.notify();
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;  ///< position: free for a producer; position + 1: holds an element.
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> tail{0};  ///< Next position to claim (producers).
+    alignas(64) size_t head = 0;              ///< Next position to read (consumer only).
+    std::atomic<bool> closed{false};
+    EventCount notEmpty;                      ///< The consumer sleeps here while the queue is empty.
+    EventCount notFull;                       ///< Producers sleep here while the queue is full.
+};
+
+#endif // MPSCQUEUE_HPP
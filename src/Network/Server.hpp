@@ -12,6 +12,17 @@
 #include <unistd.h>
 #include <cerrno>    // Pour errno
 #include <cstring>   // Pour strerror
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <algorithm>
+#include <memory>
+#include "ClientSession.hpp"   // Text command interpreter shared by all server modes.
+#include "LineBuffer.hpp"      // Newline framing of the input stream.
+#include "BinaryProtocol.hpp"  // Framed binary alternative to the text commands.
+#include "SocketWriter.hpp"    // Chunked, backpressure-aware output of replies and reports.
 
 /**
  * @class Server
@@ -55,7 +66,7 @@ public:
      *
      * Ensures the server is stopped and resources are released.
      */
-    ~Server(){}
+    virtual ~Server(){}
 
     /**
      * @brief Starts the server.
@@ -104,9 +115,15 @@ public:
      * @return `true` if the client was successfully removed; `false` if the client was not found.
      */
     virtual bool removeClient(int clientID) {
-        std::lock_guard<std::mutex> lock(client_mutex); // Assurer un accès thread-safe.
+        bool removed, last;
+        {
+            std::lock_guard<std::mutex> lock(client_mutex); // Assurer un accès thread-safe.
+            removed = connectedClients.erase(clientID) > 0;
+            last = removed && connectedClients.empty();
+        }
+        // `stop()` may join threads that take `client_mutex` (accepting or dropping clients): it must run unlocked.
 
-        if (connectedClients.erase(clientID)) {
+        if (removed) {
             // Fermer le socket du client (si ce n'est pas déjà fait)
             if (shutdown(clientID, SHUT_RDWR) < 0) {
                 std::cerr << "Erreur lors du shutdown du socket du client " << clientID << ": " << strerror(errno) << std::endl;
@@ -120,7 +137,7 @@ public:
             std::cout << "Client " << clientID << " déconnecté." << std::endl;
 
             // Vérifier si le serveur doit s'arrêter
-            if (connectedClients.empty()) {
+            if (last) {
                 std::cout << "No clients are connected." << std::endl;
                 stop();
             }
@@ -133,6 +150,288 @@ public:
     }
 
 protected:
+    /**
+     * @brief Runs the text protocol on a connected client until it disconnects or sends `shutdown`.
+     *
+     * Every read is appended to a per-connection `LineBuffer`; all complete commands it holds are executed in
+     * order, and their replies (plus one MST report from `analyzer`) are streamed through a `SocketWriter`, so a
+     * batch of short replies goes out in one send and a large report in fixed-size chunks. Pipelined commands
+     * are therefore all answered, and commands split across reads are completed by the next read.
+     * A client whose first bytes are the binary magic is handed over to `BinaryProtocol::serve` instead.
+     *
+     * @param client_socket The socket descriptor for the client.
+     * @param analyzer Writes the MST report sent after each batch of commands.
+     */
+    void serveClient(int client_socket, const ClientSession::Analyzer& analyzer) {
+        std::string helpMenu = ClientSession::helpMenu();
+        send(client_socket, helpMenu.c_str(), helpMenu.size(), 0); // Send help menu to the client.
+
+        ClientSession session(analyzer);
+        LineBuffer input;
+        bool firstRead = true; // Binary mode can only be requested by the first bytes of the connection.
+
+        while (running) { // Process commands while the server is active.
+            if (input.readFrom(client_socket) <= 0) { // Handle client disconnection.
+                std::cout << "Client disconnected." << std::endl;
+                break;
+            }
+
+            // A client opening with the binary magic switches the connection to the framed binary protocol.
+            if (firstRead && input.size() >= sizeof(BinaryProtocol::MAGIC)) {
+                char magic[sizeof(BinaryProtocol::MAGIC)];
+                input.peek(magic, sizeof(magic));
+                if (BinaryProtocol::isHandshake(magic, sizeof(magic))) {
+                    std::string pending = input.takeAll().substr(sizeof(magic));
+                    if (BinaryProtocol::serve(client_socket, std::move(pending), running) == BinaryProtocol::Outcome::Shutdown) {
+                        removeClient(client_socket);
+                    } else {
+                        dropClient(client_socket);
+                    }
+                    return;
+                }
+            }
+            firstRead = false;
+
+            SocketWriter output(client_socket);
+            bool open = session.processLines(input, output);
+            if (!output.flush()) {
+                std::cerr << "Error sending response to client " << client_socket << ": " << strerror(errno) << std::endl;
+                break;
+            }
+
+            if (!open) { // The client sent `shutdown`.
+                // Optional: Wait a short moment to ensure the client receives the message
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+                // Remove the client (also closes the socket and checks if the server should stop)
+                if (removeClient(client_socket)) {
+                    std::cout << "Client " << client_socket << " has been successfully removed and disconnected." << std::endl;
+                } else {
+                    std::cerr << "Failed to remove client " << client_socket << "." << std::endl;
+                }
+                return;
+            }
+        }
+
+        dropClient(client_socket); // Close the client connection.
+    }
+
+    /// Result of `serviceConnection()`.
+    enum class ConnectionStatus {
+        Open,     ///< Wait for the events of `Connection::wantsInput()` / `wantsOutput()`.
+        Closed,   ///< The client disconnected or the connection failed.
+        Shutdown  ///< The client sent `shutdown` and its reply has been sent.
+    };
+
+    /// Bytes read from one connection per readiness event, so that a client pipelining steadily cannot keep a
+    /// thread to itself: the rest stays in the socket and is read after the connection has been re-armed.
+    static constexpr size_t READ_BUDGET = 256 * 1024;
+
+    /// Size of the MST report chunks queued at a time: a connection buffers at most about this much of its report,
+    /// however large the graph, and produces the next chunk once the socket has accepted the previous one.
+    static constexpr size_t OUTPUT_CHUNK = 64 * 1024;
+
+    /**
+     * @brief State of a non-blocking connection driven by readiness events (event-driven modes).
+     *
+     * The connection is serviced by one thread at a time (the sockets are registered EPOLLONESHOT), so its
+     * state needs no lock. The help menu is queued in `output` when the connection is created. The MST report
+     * that follows a batch of commands is not rendered up front: the session only leaves a `ReportCursor`, which
+     * `flushOutput()` advances `OUTPUT_CHUNK` bytes at a time as the socket drains. A connection opening with the
+     * binary magic switches to the framed binary protocol, whose frames are parsed from `frames` as they arrive,
+     * on the same non-blocking socket.
+     */
+    struct Connection {
+        explicit Connection(int fd)
+            : fd(fd),
+              session([this](Graph& graph, TextSink&) {
+                  graph.Solve();
+                  report = std::make_unique<ReportCursor>(graph); // The input, hence the graph, waits for it.
+              }),
+              output(ClientSession::helpMenu()) {}
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        int fd;
+        LineBuffer input;
+        ClientSession session;
+        std::string output;       ///< Reply bytes, sent up to `outputSent`.
+        size_t outputSent = 0;
+        std::unique_ptr<ReportCursor> report; ///< Rest of the MST report, queued in `output` once it has room.
+        bool firstRead = true;    ///< Binary mode can only be requested by the first bytes of the connection.
+        bool closing = false;     ///< Close once `output` is flushed, with `closeStatus`.
+        ConnectionStatus closeStatus = ConnectionStatus::Shutdown;
+        // Binary mode.
+        bool binary = false;
+        std::string frames;       ///< Binary input, handled up to `framesConsumed`.
+        size_t framesConsumed = 0;
+        std::shared_ptr<Graph> binaryGraph;
+
+        bool outputPending() const { return outputSent < output.size() || report; }
+        /// Input is only read while no output is pending: a client that does not read its replies stops being
+        /// read too, instead of making the server buffer them without bound.
+        bool wantsInput() const { return !closing && !outputPending(); }
+        bool wantsOutput() const { return outputPending(); }
+    };
+
+    /**
+     * @brief Handles one readiness event of a non-blocking connection.
+     *
+     * Sends pending output; then, as long as nothing is left to send, reads (at most `READ_BUDGET` bytes) until
+     * the socket would block, runs the complete commands or frames, and writes as much of the replies as the
+     * socket accepts. Whatever remains waits for the next event the connection asks for.
+     * A socket reported in error or hung up is closed at once: nothing can be sent to its client any more.
+     *
+     * @param connection The connection, whose socket must be non-blocking.
+     * @param events The epoll events reported for the socket.
+     */
+    ConnectionStatus serviceConnection(Connection& connection, uint32_t events) {
+        if (events & (EPOLLERR | EPOLLHUP)) return ConnectionStatus::Closed;
+
+        bool alive = flushOutput(connection);
+        size_t budget = READ_BUDGET;
+        StringSink output(connection.output);
+        while (alive && connection.wantsInput()) {
+            if (connection.binary && handleFrame(connection)) { // Buffered frames go first.
+                alive = flushOutput(connection);
+                continue;
+            }
+            if (budget == 0) break; // Level-triggered EPOLLIN brings the connection back for the rest.
+
+            long bytesRead = connection.binary ? readFrames(connection) : connection.input.readFrom(connection.fd);
+            if (bytesRead < 0 && errno == EINTR) continue;
+            if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (bytesRead <= 0) { // Handle client disconnection.
+                alive = false;
+                break;
+            }
+            budget -= std::min(budget, static_cast<size_t>(bytesRead));
+            if (connection.binary) continue;
+
+            if (connection.firstRead && connection.input.size() >= sizeof(BinaryProtocol::MAGIC)) {
+                char magic[sizeof(BinaryProtocol::MAGIC)];
+                connection.input.peek(magic, sizeof(magic));
+                if (BinaryProtocol::isHandshake(magic, sizeof(magic))) {
+                    connection.binary = true;
+                    connection.frames = connection.input.takeAll().substr(sizeof(magic));
+                    output.write(BinaryProtocol::handshakeReply());
+                    alive = flushOutput(connection);
+                    continue;
+                }
+            }
+            connection.firstRead = false;
+
+            if (!connection.session.processLines(connection.input, output)) {
+                connection.closing = true; // The client sent `shutdown`.
+            }
+            alive = flushOutput(connection) && alive;
+        }
+
+        if (connection.closing && (!connection.outputPending() || !alive)) return connection.closeStatus;
+        return alive ? ConnectionStatus::Open : ConnectionStatus::Closed;
+    }
+
+    /**
+     * @brief Reads once from a binary connection's socket into its frame buffer.
+     * @return The number of bytes read, 0 on end of stream, or -1 on error.
+     */
+    static long readFrames(Connection& connection) {
+        if (connection.framesConsumed > 0 && connection.framesConsumed * 2 >= connection.frames.size()) {
+            connection.frames.erase(0, connection.framesConsumed);
+            connection.framesConsumed = 0;
+        }
+        char buffer[16384];
+        ssize_t n = read(connection.fd, buffer, sizeof(buffer));
+        if (n > 0) connection.frames.append(buffer, static_cast<size_t>(n));
+        return static_cast<long>(n);
+    }
+
+    /**
+     * @brief Answers the next buffered frame of a binary connection, if it is complete.
+     * @return `false` if no whole frame is buffered.
+     */
+    static bool handleFrame(Connection& connection) {
+        uint32_t length = 0;
+        const char* data = connection.frames.data() + connection.framesConsumed;
+        switch (BinaryProtocol::peekFrame(data, connection.frames.size() - connection.framesConsumed, length)) {
+            case BinaryProtocol::FrameStatus::Incomplete:
+                return false;
+            case BinaryProtocol::FrameStatus::TooLarge:
+                connection.output += BinaryProtocol::frameTooLarge();
+                connection.closing = true;
+                connection.closeStatus = ConnectionStatus::Closed;
+                return true;
+            case BinaryProtocol::FrameStatus::Complete:
+                break;
+        }
+        uint8_t opcode = length > 0 ? static_cast<uint8_t>(data[4]) : 0;
+        connection.output += BinaryProtocol::handle(data + 4, length, connection.binaryGraph);
+        connection.framesConsumed += 4 + static_cast<size_t>(length);
+        if (opcode == BinaryProtocol::SHUTDOWN) connection.closing = true;
+        return true;
+    }
+
+    /**
+     * @brief Writes as much pending output as a non-blocking socket accepts.
+     *
+     * Whenever less than `OUTPUT_CHUNK` bytes are left to send, the next chunk of the report is appended first,
+     * so a small report leaves with the replies in one send. The sent prefix is only dropped at that point (it
+     * then holds less than a chunk to move), and the buffer is emptied once everything has been sent.
+     *
+     * @return `false` if the connection failed.
+     */
+    static bool flushOutput(Connection& connection) {
+        while (true) {
+            while (connection.report && connection.output.size() - connection.outputSent < OUTPUT_CHUNK) {
+                connection.output.erase(0, connection.outputSent);
+                connection.outputSent = 0;
+                StringSink sink(connection.output);
+                if (!connection.report->next(sink, OUTPUT_CHUNK)) connection.report.reset();
+            }
+            if (connection.outputSent == connection.output.size()) break;
+
+            ssize_t n = send(connection.fd, connection.output.data() + connection.outputSent,
+                             connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            if (n <= 0) return false;
+            connection.outputSent += static_cast<size_t>(n);
+        }
+        connection.output.clear();
+        connection.outputSent = 0;
+        if (connection.output.capacity() > OUTPUT_CHUNK) connection.output.shrink_to_fit(); // Idle connections stay small.
+        return true;
+    }
+
+    /**
+     * @brief Releases a connection that `serviceConnection()` reported as Closed or Shutdown.
+     *
+     * A `shutdown` goes through `removeClient()` like in the blocking modes (which stops the server once no
+     * client is left); a disconnected client is forgotten and its socket closed.
+     */
+    void finishConnection(int fd, ConnectionStatus status) {
+        if (status == ConnectionStatus::Shutdown) {
+            if (removeClient(fd)) {
+                std::cout << "Client " << fd << " has been successfully removed and disconnected." << std::endl;
+            }
+        } else {
+            std::cout << "Client disconnected." << std::endl;
+            dropClient(fd);
+        }
+    }
+
+    /**
+     * @brief Forgets a disconnected client and closes its socket, without the server stop of `removeClient()`.
+     */
+    void dropClient(int fd) {
+        {
+            std::lock_guard<std::mutex> lock(client_mutex);
+            connectedClients.erase(fd);
+        }
+        close(fd);
+        std::cout << "Client socket closed." << std::endl;
+    }
+
     /**
      * @brief Configures the server socket.
      *
@@ -165,7 +464,7 @@ protected:
         }
 
         // Start listening for incoming connections.
-        if (listen(server_fd, 10) < 0) {
+        if (listen(server_fd, SOMAXCONN) < 0) { // A deep backlog absorbs connection bursts.
             closeSocket();
             throw std::runtime_error("Failed to start listening.");
         }
@@ -0,0 +1,228 @@
+#ifndef SERVER_EV_HPP
+#define SERVER_EV_HPP
+
+#include <memory>
+#include <unordered_map>
+#include <sys/eventfd.h>
+#include "Server.hpp"
+#include "ThreadPool.hpp"              // Work-stealing pool running the connection handlers.
+#include "ClientSession.hpp"           // Text command interpreter shared by all server modes.
+#include "LineBuffer.hpp"              // Newline framing of the input stream.
+#include "BinaryProtocol.hpp"          // Framed binary alternative to the text commands.
+#include "../../src/Model/Graph.hpp"   // Graph model used for MST operations.
+
+/**
+ * @class Server_EV
+ * @brief Implements an event-driven server: one epoll reactor thread and a pool of worker threads.
+ *
+ * All sockets are non-blocking. The reactor thread only waits in `epoll_wait`, accepts new connections and
+ * dispatches ready client sockets to the workers; an idle client costs no thread, so a few threads can keep
+ * thousands of connections open. Client sockets are registered with EPOLLONESHOT: once a socket has been
+ * dispatched, it reports no further events until its worker re-arms it, so at most one worker touches a
+ * connection at a time and the per-connection state needs no lock. The worker drains the socket, runs the
+ * commands (and the MST computation) and writes as much of the reply as the socket accepts; the rest is sent
+ * when EPOLLOUT fires. The MST report is produced `OUTPUT_CHUNK` bytes at a time as the socket drains, so its
+ * size does not bound the memory of a connection. While a reply is pending the connection only waits for
+ * EPOLLOUT, and one event reads at most `READ_BUDGET` bytes, so no client can hold a worker or make the server
+ * buffer without bound.
+ *
+ * A client that negotiates the binary protocol stays on the same non-blocking socket: its frames are parsed
+ * from the bytes received so far and answered one by one, exactly like text commands.
+ */
+class Server_EV : public Server {
+
+private:
+    int num_workers;
+    int epoll_fd;
+    int wake_fd;                                       ///< eventfd that interrupts `epoll_wait` on stop.
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    std::mutex connections_mutex;
+
+    std::unique_ptr<ThreadPool> workers;               ///< Runs the connection handlers; created by start().
+
+public:
+
+    /**
+     * @brief Constructor for the event-driven server.
+     *
+     * @param addr Server address (IP).
+     * @param port Server port number.
+     * @param num_threads Number of worker threads running commands and MST computations.
+     */
+    Server_EV(const std::string& addr, int port, int num_threads)
+        : Server(addr, port), num_workers(num_threads), epoll_fd(-1), wake_fd(-1) {
+        setupServerSocket(); // Sets up the server socket.
+        std::cout << "Server_EV configured on " << address << ":" << port << std::endl;
+    }
+
+    /**
+     * @brief Runs the reactor loop until `stop()` is called.
+     */
+    void start() override {
+        if (running.exchange(true)) { // Prevents multiple server starts.
+            std::cout << "Server_EV is already running." << std::endl;
+            return;
+        }
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd < 0 || wake_fd < 0) {
+            std::cerr << "Failed to create the epoll instance: " << strerror(errno) << std::endl;
+            running = false;
+            return;
+        }
+        setNonBlocking(server_fd);
+        watch(server_fd, EPOLLIN, EPOLL_CTL_ADD);
+        watch(wake_fd, EPOLLIN, EPOLL_CTL_ADD);
+
+        workers = std::make_unique<ThreadPool>(num_workers);
+
+        std::cout << "Server_EV started with " << num_workers << " workers." << std::endl;
+
+        epoll_event events[256];
+        while (running) {
+            int ready = epoll_wait(epoll_fd, events, 256, -1);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+                break;
+            }
+            for (int i = 0; i < ready; ++i) {
+                int fd = events[i].data.fd;
+                uint32_t flags = events[i].events;
+                if (fd == wake_fd) {
+                    continue; // `running` was cleared by stop().
+                } else if (fd == server_fd) {
+                    acceptClients();
+                } else {
+                    workers->submit([this, fd, flags]() { onReady(fd, flags); });
+                }
+            }
+        }
+
+        shutdownReactor();
+        std::cout << "Server_EV has stopped accepting new connections." << std::endl;
+    }
+
+    /**
+     * @brief Stops the server. Safe to call from any thread, including a worker.
+     */
+    void stop() override {
+        if (!running.exchange(false)) { // Empêche les arrêts multiples.
+            std::cout << "Server_EV is not running." << std::endl;
+            return;
+        }
+
+        std::cout << "Stopping Server_EV..." << std::endl;
+
+        // Wake the reactor, which releases the workers and the sockets on its way out.
+        uint64_t one = 1;
+        if (write(wake_fd, &one, sizeof(one)) < 0) {
+            std::cerr << "Error waking the reactor: " << strerror(errno) << std::endl;
+        }
+    }
+
+    /**
+     * @brief Serves a blocking socket until it disconnects; the workers use `onReady` instead.
+     */
+    void handleClient(int client_socket) override {
+        serveClient(client_socket, analyze);
+    }
+
+private:
+    /// Streams the MST report sent after each batch of commands to a blocking client.
+    static void analyze(Graph& graph, TextSink& output) {
+        graph.Solve();
+        graph.writeAnalysis(output); // Summarizes the graph and its MST.
+    }
+
+    static void setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    void watch(int fd, uint32_t events, int operation) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd, operation, fd, &event) < 0) {
+            std::cerr << "epoll_ctl failed for fd " << fd << ": " << strerror(errno) << std::endl;
+        }
+    }
+
+    /// Re-arms a one-shot client registration for the events the connection waits for.
+    void rearm(const Connection& connection) {
+        uint32_t events = EPOLLONESHOT;
+        if (connection.wantsInput()) events |= EPOLLIN | EPOLLRDHUP;
+        if (connection.wantsOutput()) events |= EPOLLOUT;
+        watch(connection.fd, events, EPOLL_CTL_MOD);
+    }
+
+    /// Accepts every pending connection (the listening socket is non-blocking).
+    void acceptClients() {
+        while (true) {
+            sockaddr_in client_addr{};
+            socklen_t client_len = sizeof(client_addr);
+            int client_socket = accept4(server_fd, (struct sockaddr*)&client_addr, &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client_socket < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
+                }
+                if (errno == EINTR) continue;
+                return;
+            }
+
+            if (!addClient(client_socket)) { // Reject the connection if the client cannot be added.
+                close(client_socket);
+                continue;
+            }
+
+            auto connection = std::make_shared<Connection>(client_socket);
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                connections[client_socket] = connection;
+            }
+            flushOutput(*connection);
+            watch(client_socket, EPOLLIN | EPOLLRDHUP | EPOLLONESHOT | (connection->wantsOutput() ? EPOLLOUT : 0), EPOLL_CTL_ADD);
+        }
+    }
+
+    /// Handles the readiness of one client socket on a worker thread.
+    void onReady(int fd, uint32_t events) {
+        std::shared_ptr<Connection> connection;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            auto it = connections.find(fd);
+            if (it == connections.end()) return;
+            connection = it->second;
+        }
+
+        ConnectionStatus status = serviceConnection(*connection, events);
+        if (status == ConnectionStatus::Open) {
+            rearm(*connection);
+            return;
+        }
+
+        // Forget the connection before its descriptor is closed (and possibly reused by accept).
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            connections.erase(fd);
+        }
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        finishConnection(fd, status);
+    }
+
+    /// Runs on the reactor thread once the loop has ended: stops the workers and releases every socket.
+    void shutdownReactor() {
+        workers.reset(); // Runs the handlers already dispatched, then joins the workers.
+
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (auto& entry : connections) close(entry.first);
+        connections.clear();
+        close(epoll_fd);
+        close(wake_fd);
+        close(server_fd);
+    }
+};
+
+#endif // SERVER_EV_HPP
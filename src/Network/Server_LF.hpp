@@ -2,17 +2,26 @@
 #include <sstream>
 #include <cerrno>    // Pour errno
 #include <cstring>   // Pour strerror
+#include <memory>
+#include <unordered_map>
 #include "LeaderFollowers.hpp"       // Includes Leader-Followers thread pool implementation.
 #include "../../src/Model/Graph.hpp" // Includes the Graph class for graph operations.
 
 /**
  * @class Server_LF
  * @brief Implements a server using the Leader-Followers pattern.
+ *
+ * The listening socket and all client sockets (non-blocking) are registered in the pool's epoll handle. The
+ * leader thread waits on that handle; when a connection request or client input arrives, it promotes a follower
+ * and then accepts the connection or runs the client's commands and MST computation itself. The MST report is
+ * written a chunk at a time, each time the client's socket becomes writable (see `Server::Connection`).
  */
 class Server_LF : public Server {
 
 private:
-    LeaderFollowers thread_pool; // Thread pool for handling client tasks.
+    LeaderFollowers thread_pool; // Leader/Followers threads sharing the demultiplexing handle.
+    std::unordered_map<int, std::shared_ptr<Connection>> connections; // Client state, keyed by socket.
+    std::mutex connections_mutex;
 
 public:
 
@@ -32,7 +41,7 @@ public:
     /**
      * @brief Starts the Leader-Followers server.
      *
-     * Accepts client connections and assigns them to threads in the pool.
+     * Registers the listening socket and starts the threads, then blocks until the server is stopped.
      */
     void start() override {
         if (running.exchange(true)) { // Empêche les démarrages multiples.
@@ -40,42 +49,39 @@ public:
             return;
         }
 
-        std::cout << "Server_LF started." << std::endl;
-
-        while (running) { // Boucle principale du serveur.
-            sockaddr_in client_addr{}; // Informations sur le client.
-            socklen_t client_len = sizeof(client_addr);
-            int client_socket = accept(server_fd, (struct sockaddr*)&client_addr, &client_len);
+        int flags = fcntl(server_fd, F_GETFL, 0);
+        fcntl(server_fd, F_SETFL, flags | O_NONBLOCK); // The leader accepts until the backlog is empty.
+        thread_pool.add_handle(server_fd);
+        thread_pool.start([this](int fd, uint32_t events) { onEvent(fd, events); });
 
-            if (client_socket < 0) { // Gérer les erreurs lors de la connexion.
-                if (!running) {
-                    std::cout << "Server is shutting down. Exiting accept loop." << std::endl;
-                    break; // Sortir de la boucle si le serveur est en cours d'arrêt.
-                }
-                std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
-                continue;
-            }
+        std::cout << "Server_LF started." << std::endl;
 
-            std::cout << "New client connected: " << client_socket << std::endl;
+        thread_pool.wait(); // Les threads du pool servent les connexions jusqu'à l'arrêt.
+        thread_pool.join(); // From outside the pool: no handler is left running once it returns.
 
-            if (!addClient(client_socket)) { // Rejeter la connexion si le client ne peut pas être ajouté.
-                close(client_socket);
-                continue;
-            }
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            for (auto& entry : connections) close(entry.first);
+            connections.clear();
+        }
 
-            // Assigner le client au pool de threads.
-            thread_pool.add_task([this, client_socket]() {
-                handleClient(client_socket);
-            });
+        // Fermer le socket du serveur
+        if (shutdown(server_fd, SHUT_RDWR) < 0 && errno != ENOTCONN) {
+            std::cerr << "Error shutting down server socket: " << strerror(errno) << std::endl;
         }
 
+        close(server_fd);
+
         std::cout << "Server_LF has stopped accepting new connections." << std::endl;
     }
 
+    /**
+     * @brief Stops the server.
+     *
+     * May be called by an event handler (the last client's `shutdown`), so it only releases the pool's threads:
+     * `start()` joins them from outside the pool, then closes the sockets.
+     */
     void stop() override {
-
-        thread_pool.stop();
-
         if (!running.exchange(false)) { // Empêche les arrêts multiples.
             std::cout << "Server_LF is not running." << std::endl;
             return;
@@ -83,179 +89,89 @@ public:
 
         std::cout << "Stopping Server_LF..." << std::endl;
 
-        // Fermer le socket du serveur pour interrompre `accept()`
-        if (shutdown(server_fd, SHUT_RDWR) < 0) {
-            std::cerr << "Error shutting down server socket: " << strerror(errno) << std::endl;
-        }
-
-        close(server_fd);
+        thread_pool.stop();
     }
 
     /**
      * @brief Handles client communication.
      *
-     * Processes graph commands and responds to the client.
+     * Serves a blocking socket until it disconnects; the pool threads use `onEvent` instead.
+     * The MST report sent after each batch of commands is streamed by `Graph::writeAnalysis()`.
      *
      * @param client_socket The socket descriptor for the client.
      */
     void handleClient(int client_socket) override {
-        std::shared_ptr<Graph> graph;
+        serveClient(client_socket, analyze);
+    }
 
-        // Prepare the help menu to send to the client.
-        std::string helpMenu = "------------------------ COMMAND MENU --------------------------------------------\n";
-        helpMenu += "Create a new graph:\n   - Syntax: 'create <number_of_vertices>'\n";
-        helpMenu += "Add an edge:\n   - Syntax: 'add <u> <v> <w>'\n";
-        helpMenu += "Remove an edge:\n   - Syntax: 'remove <u> <v>'\n";
-        helpMenu += "Choose MST Algorithm:\n   - Syntax: 'algo <algorithm_name>'\n     (prim/kruskal/tarjan/boruvka/integer_mst)\n";
-        helpMenu += "Shutdown:\n   - Syntax: 'shutdown'\n";
-        helpMenu += "----------------------------------------------------------------------------------\n";
+private:
+    /// Streams the MST report sent after each batch of commands to a blocking client.
+    static void analyze(Graph& graph, TextSink& output) {
+        graph.Solve();
+        graph.writeAnalysis(output); // Summarizes the graph and its MST.
+    }
 
-        send(client_socket, helpMenu.c_str(), helpMenu.size(), 0); // Send help menu to the client.
+    /// Processes one event in the thread that was the leader when it arrived.
+    void onEvent(int fd, uint32_t events) {
+        if (fd == server_fd) {
+            acceptClients();
+            thread_pool.reactivate_handle(server_fd);
+            return;
+        }
 
-        char buffer[1024]; // Buffer to receive client commands.
-        while (running) { // Process commands while the server is active.
-            int bytesRead = read(client_socket, buffer, sizeof(buffer)); // Read data from the client.
-            if (bytesRead <= 0) { // Handle client disconnection.
-                std::cout << "Client disconnected." << std::endl;
-                break;
-            }
+        std::shared_ptr<Connection> connection;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            auto it = connections.find(fd);
+            if (it == connections.end()) return;
+            connection = it->second;
+        }
 
-            // Parse the received command.
-            std::string request(buffer, bytesRead);
-            std::stringstream ss(request);
-            std::string command;
-            ss >> command;
+        ConnectionStatus status = serviceConnection(*connection, events);
+        if (status == ConnectionStatus::Open) {
+            thread_pool.reactivate_handle(fd, connection->wantsOutput(), connection->wantsInput());
+            return;
+        }
 
-            if (command == "create") { // Create a graph.
-                std::string token;
-                if (ss >> token) {
-                    try {
-                        int size = std::stoi(token);
-                        if (size <= 0) { // Vérifie si le nombre de sommets est <= 0.
-                            std::string response =
-                                "Error: Number of vertices must be > 0.\n"
-                                "Try again: create <number_of_vertices>\n";
-                            send(client_socket, response.c_str(), response.size(), 0);
-                        } else {
-                            // Vérifie s'il y a des arguments supplémentaires
-                            std::string extra;
-                            if (ss >> extra) { // Arguments supplémentaires détectés.
-                                std::string response =
-                                    "Error: Too many arguments provided.\n"
-                                    "Syntax: create <number_of_vertices>\n"
-                                    "Example: create 5\n";
-                                send(client_socket, response.c_str(), response.size(), 0);
-                            } else { // Aucun argument supplémentaire, commande valide.
-                                graph = std::make_unique<Graph>(size);
-                                std::string response =
-                                    "Graph created with " + std::to_string(size) + " vertices.\n";
-                                send(client_socket, response.c_str(), response.size(), 0);
-                            }
-                        }
-                    } catch (...) {
-                        std::string response =
-                            "Invalid input. Syntax: create <number_of_vertices>\n"
-                            "Example: create 5\n";
-                        send(client_socket, response.c_str(), response.size(), 0);
-                    }
-                } else {
-                    std::string response =
-                        "Error: Missing argument. Syntax: create <number_of_vertices>\n"
-                        "Example: create 5\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                }
-            }
-            else if (command == "add") { // Add an edge.
-                if (!graph) {
-                    std::string response = "Graph not created. Use 'create' first.\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                    continue;
-                }
-                int u, v, weight;
-                if (ss >> u >> v >> weight) {
-                    graph->add_edge(u, v, weight);
-                    std::string response = "Edge added: (" + std::to_string(u) + ", " + std::to_string(v) + ") with weight " + std::to_string(weight) + "\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                } else {
-                    std::string response = "Invalid input. Syntax: 'add <u> <v> <w>'\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                }
-            }
-            else if (command == "remove") { // Remove an edge.
-                if (!graph) {
-                    std::string response = "Graph not created. Use 'create' first.\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                    continue;
-                }
-                int u, v;
-                if (ss >> u >> v) {
-                    graph->remove_edge(u, v);
-                    std::string response = "Edge removed: (" + std::to_string(u) + ", " + std::to_string(v) + ")\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                } else {
-                    std::string response = "Invalid input. Syntax: 'remove <u> <v>'\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                }
-            }
-            else if (command == "algo") { // Set MST algorithm.
-                if (!graph) {
-                    std::cerr << "Graph not initialized when trying to set algorithm." << std::endl;
-                    std::string response = "Error: Graph not created. Use 'create' first.\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                    continue;
-                }
-                std::string selectedAlgorithm;
-                if (ss >> selectedAlgorithm) {
-                    if (selectedAlgorithm == "prim" || selectedAlgorithm == "kruskal" ||
-                        selectedAlgorithm == "boruvka" || selectedAlgorithm == "tarjan" ||
-                        selectedAlgorithm == "integer_mst") {
-                        graph->_algorithmChoice = selectedAlgorithm;
-                        std::string response = "Algorithm set to " + selectedAlgorithm + ".\n";
-                        send(client_socket, response.c_str(), response.size(), 0);
-                    } else {
-                        std::string response = "Error: Unknown algorithm '" + selectedAlgorithm + "'.\n";
-                        send(client_socket, response.c_str(), response.size(), 0);
-                    }
-                } else {
-                    std::string response = "Invalid input. Syntax: 'algo <algorithm_name>'\n";
-                    send(client_socket, response.c_str(), response.size(), 0);
-                }
-            }
-            else if (command == "shutdown") { // Command to disconnect the client from the server
-                std::string response = "Shutting down client.\n";
-                ssize_t bytes_sent = send(client_socket, response.c_str(), response.size(), 0);
-                if (bytes_sent < 0) {
-                    std::cerr << "Error sending response to client " << client_socket << ": " << strerror(errno) << std::endl;
-                }
+        // Forget the connection before its descriptor is closed (and possibly reused by accept).
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            connections.erase(fd);
+        }
+        thread_pool.remove_handle(fd);
+        finishConnection(fd, status);
+    }
 
-                // Optional: Wait a short moment to ensure the client receives the message
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    /// Accepts every pending connection and registers it in the demultiplexing handle.
+    void acceptClients() {
+        while (running) {
+            sockaddr_in client_addr{}; // Informations sur le client.
+            socklen_t client_len = sizeof(client_addr);
+            int client_socket = accept4(server_fd, (struct sockaddr*)&client_addr, &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
 
-                // Remove the client (also closes the socket and checks if the server should stop)
-                if (removeClient(client_socket)) {
-                    std::cout << "Client " << client_socket << " has been successfully removed and disconnected." << std::endl;
-                } else {
-                    std::cerr << "Failed to remove client " << client_socket << "." << std::endl;
+            if (client_socket < 0) { // Gérer les erreurs lors de la connexion.
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
                 }
+                return;
+            }
 
-                // No need to lock the mutex again here if removeClient handles it
+            std::cout << "New client connected: " << client_socket << std::endl;
 
-                break; // Exit handling for this client.
-            }
-            else { // Handle unknown commands.
-                std::string response = "Unknown command. Use 'help' for a list of commands.\n";
-                send(client_socket, response.c_str(), response.size(), 0);
+            if (!addClient(client_socket)) { // Rejeter la connexion si le client ne peut pas être ajouté.
+                close(client_socket);
+                continue;
             }
 
-            if (graph) {
-                graph->Solve();
-                std::string analysis = graph->Analysis(); // Assume this method summarizes MST analysis.
-                send(client_socket, analysis.c_str(), analysis.size(), 0);
+            auto connection = std::make_shared<Connection>(client_socket);
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                connections[client_socket] = connection;
             }
+            flushOutput(*connection); // Sends the help menu.
+            thread_pool.add_handle(client_socket, connection->wantsOutput());
         }
-
-        close(client_socket); // Close the client connection.
-        std::cout << "Client socket closed." << std::endl;
     }
 
 };
\ No newline at end of file
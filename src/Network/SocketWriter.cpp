@@ -0,0 +1,89 @@
+#include "SocketWriter.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+SocketWriter::SocketWriter(int socket) : socket(socket), buffer(new char[BUFFER_SIZE]) {}
+
+void SocketWriter::write(const char* data, size_t size) {
+    if (failed) return;
+    if (size <= BUFFER_SIZE - used) {
+        std::memcpy(buffer.get() + used, data, size);
+        used += size;
+        if (used == BUFFER_SIZE) sendAll(nullptr, 0);
+        return;
+    }
+    if (size < BUFFER_SIZE) { // Fill the buffer, send it, and keep the rest.
+        size_t head = BUFFER_SIZE - used;
+        std::memcpy(buffer.get() + used, data, head);
+        used = BUFFER_SIZE;
+        if (!sendAll(nullptr, 0)) return;
+        std::memcpy(buffer.get(), data + head, size - head);
+        used = size - head;
+        return;
+    }
+    sendAll(data, size); // Too large to stage: gathered with the buffered bytes, without a copy.
+}
+
+bool SocketWriter::flush() {
+    if (!failed && used > 0) sendAll(nullptr, 0);
+    return !failed;
+}
+
+// Sends the buffered bytes followed by `extra`, resuming after partial writes, and empties the buffer.
+bool SocketWriter::sendAll(const char* extra, size_t extraSize) {
+    size_t bufferSent = 0, extraSent = 0;
+    while (bufferSent < used || extraSent < extraSize) {
+        iovec chunks[2];
+        int count = 0;
+        if (bufferSent < used) {
+            chunks[count].iov_base = buffer.get() + bufferSent;
+            chunks[count].iov_len = used - bufferSent;
+            ++count;
+        }
+        if (extraSent < extraSize) {
+            chunks[count].iov_base = const_cast<char*>(extra + extraSent);
+            chunks[count].iov_len = extraSize - extraSent;
+            ++count;
+        }
+
+        msghdr message{};
+        message.msg_iov = chunks;
+        message.msg_iovlen = count;
+        ssize_t n = sendmsg(socket, &message, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (waitWritable()) continue;
+            failed = true;
+            break;
+        }
+        if (n <= 0) {
+            failed = true;
+            break;
+        }
+
+        // Skip what was written, possibly ending in the middle of the buffer.
+        size_t written = static_cast<size_t>(n);
+        sent += written;
+        size_t fromBuffer = std::min(written, used - bufferSent);
+        bufferSent += fromBuffer;
+        extraSent += written - fromBuffer;
+    }
+    used = 0;
+    return !failed;
+}
+
+// Waits for a full non-blocking socket to accept more bytes.
+bool SocketWriter::waitWritable() {
+    pollfd descriptor{};
+    descriptor.fd = socket;
+    descriptor.events = POLLOUT;
+    while (true) {
+        int ready = poll(&descriptor, 1, SEND_TIMEOUT_MS);
+        if (ready < 0 && errno == EINTR) continue;
+        return ready > 0 && (descriptor.revents & POLLOUT);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef SOCKETWRITER_HPP
+#define SOCKETWRITER_HPP
+
+#include <cstddef>
+#include <memory>
+#include "../../src/Model/Graph.hpp"
+
+/**
+ * @class SocketWriter
+ * @brief Streams text to a socket through a reusable fixed-size buffer.
+ *
+ * Replies and reports are written piece by piece (`Graph::writeAnalysis` hands over its listings in small chunks),
+ * so a million-edge MST goes out in `BUFFER_SIZE` pieces instead of as one multi-hundred-MB string. The buffer is
+ * flushed with `sendmsg` once full; a piece larger than the free space is sent straight from the caller's memory,
+ * gathered with the buffered bytes. Partial writes are resumed, and when a non-blocking socket is full the writer
+ * waits (up to `SEND_TIMEOUT_MS`) for the client to drain it: a slow reader slows the writer down instead of
+ * making it buffer without bound.
+ *
+ * A failed send is sticky: further writes are dropped and `flush()` reports the failure.
+ */
+class SocketWriter : public TextSink {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+    static constexpr int SEND_TIMEOUT_MS = 30000; ///< Longest wait for a full socket to become writable.
+
+    explicit SocketWriter(int socket);
+
+    using TextSink::write;
+    void write(const char* data, size_t size) override;
+
+    /**
+     * @brief Sends the buffered bytes.
+     * @return `false` if the connection failed (now or during an earlier write).
+     */
+    bool flush();
+
+    /// Bytes accepted by the socket so far.
+    size_t bytesSent() const { return sent; }
+
+private:
+    int socket;
+    std::unique_ptr<char[]> buffer;
+    size_t used = 0;
+    size_t sent = 0;
+    bool failed = false;
+
+    bool sendAll(const char* extra, size_t extraSize);
+    bool waitWritable();
+};
+
+#endif // SOCKETWRITER_HPP
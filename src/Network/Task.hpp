@@ -0,0 +1,119 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @class Task
+ * @brief Move-only `void()` callable with a 48-byte inline buffer, the unit of work of the executors.
+ *
+ * `std::function` must be copyable and stores at most two pointers inline (libstdc++), so a lambda capturing a
+ * few values or a `shared_ptr` is heap-allocated on every submission. A `Task` is never copied, and stores any
+ * callable of up to `INLINE_SIZE` bytes with a non-throwing move constructor inside the object itself; larger
+ * callables fall back to the heap. Executors keep `Task`s by value in their queues, so submitting a typical
+ * closure does not call the allocator.
+ */
+class Task {
+public:
+    static constexpr size_t INLINE_SIZE = 48; ///< With the dispatch pointer, a Task fills one 64-byte cache line.
+
+    Task() noexcept : ops(nullptr) {}
+    Task(std::nullptr_t) noexcept : ops(nullptr) {}
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, Task>::value &&
+                                                      !std::is_same<std::decay_t<F>, std::nullptr_t>::value>>
+    Task(F&& function) : ops(nullptr) {
+        using Callable = std::decay_t<F>;
+        if constexpr (fitsInline<Callable>()) {
+            new (storage) Callable(std::forward<F>(function));
+            ops = &InlineOps<Callable>::table;
+        } else {
+            *reinterpret_cast<Callable**>(storage) = new Callable(std::forward<F>(function));
+            ops = &HeapOps<Callable>::table;
+        }
+    }
+
+    Task(Task&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                other.ops->move(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    void operator()() { ops->invoke(storage); }
+
+    /// Whether a callable of type F is stored without a heap allocation.
+    template <typename F>
+    static constexpr bool fitsInline() {
+        return sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* destination, void* source) noexcept;  ///< Moves and destroys the source.
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename F>
+    struct InlineOps {
+        static void invoke(void* storage) { (*static_cast<F*>(storage))(); }
+        static void move(void* destination, void* source) noexcept {
+            new (destination) F(std::move(*static_cast<F*>(source)));
+            static_cast<F*>(source)->~F();
+        }
+        static void destroy(void* storage) noexcept { static_cast<F*>(storage)->~F(); }
+        static constexpr Ops table = {invoke, move, destroy};
+    };
+
+    template <typename F>
+    struct HeapOps {
+        static F*& target(void* storage) { return *static_cast<F**>(storage); }
+        static void invoke(void* storage) { (*target(storage))(); }
+        static void move(void* destination, void* source) noexcept {
+            *static_cast<F**>(destination) = target(source);
+        }
+        static void destroy(void* storage) noexcept { delete target(storage); }
+        static constexpr Ops table = {invoke, move, destroy};
+    };
+
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Ops* ops;
+};
+
+#endif // TASK_HPP
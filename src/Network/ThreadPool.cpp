@@ -0,0 +1,270 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // The pool and worker the current thread belongs to, if any.
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local void* currentWorkerSlot = nullptr;
+    // Victim selection for threads that help from outside the pool.
+    thread_local uint64_t helperSeed = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t nextRandom(uint64_t& state) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+}
+
+struct ThreadPool::Job {
+    Task task;
+    std::shared_ptr<TaskGroup::State> group;  ///< Signalled when the task ends; null for a plain submit().
+};
+
+/**
+ * Free list of Job nodes: each thread keeps a small cache, and moves nodes to or from a shared list
+ * BATCH at a time, so a node freed by the worker that ran it is reused by the thread that submits next.
+ * The shared list is never destroyed, since thread-local caches may flush into it during shutdown.
+ */
+class ThreadPool::JobCache {
+public:
+    static constexpr size_t BATCH = 64;
+
+    ~JobCache() {
+        std::lock_guard<std::mutex> lock(sharedMutex());
+        for (Job* job : local) sharedList().push_back(job);
+    }
+
+    Job* acquire() {
+        if (local.empty()) {
+            std::lock_guard<std::mutex> lock(sharedMutex());
+            std::vector<Job*>& shared = sharedList();
+            size_t take = std::min(BATCH, shared.size());
+            local.insert(local.end(), shared.end() - take, shared.end());
+            shared.resize(shared.size() - take);
+        }
+        if (local.empty()) return new Job();
+        Job* job = local.back();
+        local.pop_back();
+        return job;
+    }
+
+    void release(Job* job) {
+        job->task = nullptr;
+        job->group.reset();
+        local.push_back(job);
+        if (local.size() >= 2 * BATCH) {
+            std::lock_guard<std::mutex> lock(sharedMutex());
+            sharedList().insert(sharedList().end(), local.end() - BATCH, local.end());
+            local.resize(local.size() - BATCH);
+        }
+    }
+
+private:
+    std::vector<Job*> local;
+
+    static std::mutex& sharedMutex() {
+        static std::mutex* mutex = new std::mutex();
+        return *mutex;
+    }
+
+    static std::vector<Job*>& sharedList() {
+        static std::vector<Job*>* list = new std::vector<Job*>();
+        return *list;
+    }
+};
+
+ThreadPool::JobCache& ThreadPool::jobCache() {
+    thread_local JobCache cache;
+    return cache;
+}
+
+void ThreadPool::execute(Job* job) {
+    if (job->group) {
+        TaskGroup::State& state = *job->group;
+        try {
+            job->task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state.errorMutex);
+            if (!state.error) state.error = std::current_exception();
+        }
+        std::shared_ptr<TaskGroup::State> group = std::move(job->group);
+        jobCache().release(job);
+        if (group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) group->finished.notify();
+        return;
+    }
+    try {
+        job->task();
+    } catch (const std::exception& e) {
+        std::cerr << "[ThreadPool] Task exception: " << e.what() << std::endl;
+    }
+    jobCache().release(job);
+}
+
+ThreadPool::ThreadPool(int numThreads) {
+    int count = std::max(1, numThreads);
+    for (int i = 0; i < count; ++i) {
+        workers.emplace_back(new Worker{WorkStealingDeque<Job*>(), std::thread(), 0x9E3779B97F4A7C15ULL * (i + 1)});
+    }
+    // Start the threads once every deque exists, since they steal from each other.
+    for (auto& worker : workers) {
+        worker->thread = std::thread(&ThreadPool::workerLoop, this, worker.get());
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopping.store(true, std::memory_order_release);
+    idle.notify();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(static_cast<int>(std::thread::hardware_concurrency()));
+    return pool;
+}
+
+int ThreadPool::size() const {
+    return static_cast<int>(workers.size());
+}
+
+ThreadPool::Worker* ThreadPool::currentWorker() const {
+    return currentPool == this ? static_cast<Worker*>(currentWorkerSlot) : nullptr;
+}
+
+void ThreadPool::submit(Task task) {
+    Job* job = jobCache().acquire();
+    job->task = std::move(task);
+    enqueue(job);
+}
+
+void ThreadPool::enqueue(Job* job) {
+    if (Worker* self = currentWorker()) {
+        self->deque.push(job); // A forked subtask: no shared state touched.
+    } else {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        size_t count = injectedCount.load(std::memory_order_relaxed);
+        if (count == injected.size()) { // Full: unwrap into a ring twice as large.
+            std::vector<Job*> bigger(std::max<size_t>(64, injected.size() * 2));
+            for (size_t i = 0; i < count; ++i) bigger[i] = injected[(injectedHead + i) % injected.size()];
+            injected.swap(bigger);
+            injectedHead = 0;
+        }
+        injected[(injectedHead + count) % injected.size()] = job;
+        injectedCount.store(count + 1, std::memory_order_release);
+    }
+    idle.notifyOne();
+}
+
+// Own deque first (LIFO), then the injection queue, then the other workers' deques from a random start.
+ThreadPool::Job* ThreadPool::findJob(Worker* self) {
+    if (self) {
+        if (Job* job = self->deque.take()) return job;
+    }
+
+    if (injectedCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        size_t count = injectedCount.load(std::memory_order_relaxed);
+        if (count > 0) {
+            Job* job = injected[injectedHead];
+            injectedHead = (injectedHead + 1) % injected.size();
+            injectedCount.store(count - 1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    size_t count = workers.size();
+    size_t start = static_cast<size_t>(nextRandom(self ? self->seed : helperSeed) % count);
+    for (size_t i = 0; i < count; ++i) {
+        Worker* victim = workers[(start + i) % count].get();
+        if (victim == self) continue;
+        Job* job = nullptr;
+        WorkStealingDeque<Job*>::StealStatus status;
+        while ((status = victim->deque.steal(job)) == WorkStealingDeque<Job*>::StealStatus::Contended) {}
+        if (status == WorkStealingDeque<Job*>::StealStatus::Success) return job;
+    }
+    return nullptr;
+}
+
+bool ThreadPool::runPendingTask() {
+    Job* job = findJob(currentWorker());
+    if (!job) return false;
+    execute(job);
+    return true;
+}
+
+void ThreadPool::workerLoop(Worker* self) {
+    currentPool = this;
+    currentWorkerSlot = self;
+    while (true) {
+        Job* job = findJob(self);
+        if (!job) {
+            // Register as idle, then look once more so that a task submitted in between is not missed.
+            uint32_t key = idle.prepareWait();
+            job = findJob(self);
+            if (!job) {
+                if (stopping.load(std::memory_order_acquire)) {
+                    idle.cancelWait();
+                    return;
+                }
+                idle.wait(key);
+                continue;
+            }
+            idle.cancelWait();
+        }
+        execute(job);
+    }
+}
+
+void ThreadPool::parallelFor(int slices, int count, const std::function<void(int, int, int)>& body) {
+    if (slices <= 1) {
+        body(0, 0, count);
+        return;
+    }
+    auto bound = [&](int slice) { return static_cast<int>(static_cast<long long>(count) * slice / slices); };
+    TaskGroup group(*this);
+    for (int slice = 1; slice < slices; ++slice) {
+        group.run([&body, slice, lo = bound(slice), hi = bound(slice + 1)]() { body(slice, lo, hi); });
+    }
+    body(0, 0, bound(1));
+    group.wait();
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool(pool), state(std::make_shared<State>()) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // An exception not collected by an explicit wait() is dropped.
+    }
+}
+
+void TaskGroup::run(ThreadPool::Task task) {
+    state->pending.fetch_add(1, std::memory_order_relaxed);
+    ThreadPool::Job* job = ThreadPool::jobCache().acquire();
+    job->task = std::move(task);
+    job->group = state;
+    pool.enqueue(job);
+}
+
+void TaskGroup::wait() {
+    while (state->pending.load(std::memory_order_acquire) > 0) {
+        if (pool.runPendingTask()) continue; // Help instead of blocking a worker.
+        uint32_t key = state->finished.prepareWait();
+        if (state->pending.load(std::memory_order_acquire) == 0) {
+            state->finished.cancelWait();
+            break;
+        }
+        state->finished.wait(key);
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state->errorMutex);
+        std::swap(error, state->error);
+    }
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,129 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "EventCount.hpp"         // Parking of idle workers and of TaskGroup::wait().
+#include "Task.hpp"               // Move-only task with inline storage.
+#include "WorkStealingDeque.hpp"  // Per-worker Chase–Lev deques.
+
+/**
+ * @class ThreadPool
+ * @brief Work-stealing thread pool shared by the servers and the parallel MST code.
+ *
+ * Each worker owns a Chase–Lev deque. A task submitted from a worker (a forked subtask) goes to the bottom of
+ * that worker's deque and is usually run by the same worker, with no shared state touched; idle workers steal
+ * from the top of a randomly chosen victim's deque. Tasks submitted from other threads go through a small
+ * injection queue. Idle workers sleep on a futex and are woken only when there is work.
+ *
+ * `TaskGroup` provides fork/join on top of the pool: its `wait()` runs pending tasks on the calling thread
+ * instead of blocking, so tasks may fork and wait recursively without exhausting the workers.
+ *
+ * Tasks travel in recycled `Job` nodes (thread-local caches refilled in batches from a shared free list), and a
+ * `Task` keeps small closures inline, so once the pool has warmed up a submission does not call the allocator.
+ */
+class ThreadPool {
+public:
+    using Task = ::Task;
+
+    /// @param numThreads Number of worker threads (at least 1).
+    explicit ThreadPool(int numThreads);
+
+    /// Runs the tasks still queued, then joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// The process-wide pool (one worker per hardware thread), created on first use.
+    static ThreadPool& shared();
+
+    /// Number of worker threads.
+    int size() const;
+
+    /// Queues a task; from a worker of this pool it goes to that worker's own deque.
+    void submit(Task task);
+
+    /**
+     * @brief Runs one queued task on the calling thread, if there is one.
+     * @return `false` if no task was found.
+     */
+    bool runPendingTask();
+
+    /**
+     * @brief Runs body(slice, lo, hi) over `slices` contiguous ranges of [0, count) and waits for all of them.
+     *
+     * The calling thread runs the first slice itself; a single slice runs inline.
+     */
+    void parallelFor(int slices, int count, const std::function<void(int, int, int)>& body);
+
+private:
+    friend class TaskGroup;
+
+    struct Job;       ///< A queued task, with the group it belongs to if any.
+    class JobCache;   ///< Per-thread free list of Job nodes.
+
+    struct Worker {
+        WorkStealingDeque<Job*> deque;
+        std::thread thread;
+        uint64_t seed;  ///< xorshift state for choosing steal victims.
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<Job*> injected;           ///< Ring of tasks submitted from outside the pool (grows, never shrinks).
+    size_t injectedHead = 0;
+    std::mutex injectedMutex;
+    std::atomic<size_t> injectedCount{0}; ///< Lets workers skip the mutex when nothing was injected.
+    std::atomic<bool> stopping{false};
+    EventCount idle;                      ///< Workers sleep here when no task is found.
+
+    void enqueue(Job* job);
+    void workerLoop(Worker* self);
+    Job* findJob(Worker* self);
+    Worker* currentWorker() const;
+
+    static JobCache& jobCache();
+    static void execute(Job* job);
+};
+
+/**
+ * @class TaskGroup
+ * @brief A set of tasks forked into a `ThreadPool` and joined together.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::shared());
+
+    /// Waits for the tasks that are still running.
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Forks `task` into the pool.
+    void run(ThreadPool::Task task);
+
+    /// Returns once every task of the group has finished, running pool tasks meanwhile.
+    void wait();
+
+private:
+    friend class ThreadPool;
+
+    /// Shared with the forked tasks, which may still signal it after `wait()` has returned.
+    struct State {
+        std::atomic<int> pending{0};
+        EventCount finished;         ///< The waiting thread sleeps here when it finds nothing to run.
+        std::mutex errorMutex;
+        std::exception_ptr error;    ///< First exception thrown by a task, rethrown by `wait()`.
+    };
+
+    ThreadPool& pool;
+    std::shared_ptr<State> state;
+};
+
+#endif // THREADPOOL_HPP
@@ -0,0 +1,116 @@
+#ifndef WORKSTEALINGDEQUE_HPP
+#define WORKSTEALINGDEQUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @class WorkStealingDeque
+ * @brief Chase–Lev work-stealing deque of pointers.
+ *
+ * The owner thread pushes and takes at the bottom (LIFO, so forked subtasks run while their data is still in
+ * cache) without any read-modify-write except when a single element is left; other threads steal from the top
+ * (FIFO, the oldest and usually largest tasks) with one compare-and-swap. The ring grows when full; replaced
+ * rings are kept until the deque is destroyed, since a thief may still be reading one.
+ *
+ * Memory orderings follow Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak
+ * Memory Models" (PPoPP 2013).
+ *
+ * @tparam T Pointer type of the elements; `nullptr` means "no element".
+ */
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int64_t capacity = 256) {
+        int64_t size = 2;
+        while (size < capacity) size <<= 1;
+        rings.emplace_back(new Ring(size));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /// Adds an element at the bottom (owner thread only).
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - t > r->mask) r = grow(r, t, b);
+        r->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /// Removes the most recently pushed element (owner thread only). Returns `nullptr` if empty.
+    T take() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) { // Empty.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T item = r->get(b);
+        if (t == b) { // Last element: race the thieves for it.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// Result of `steal()`.
+    enum class StealStatus { Empty, Success, Contended };
+
+    /// Removes the oldest element (any thread). `Contended` means another thread won the race: retry.
+    StealStatus steal(T& out) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return StealStatus::Empty;
+        Ring* r = ring.load(std::memory_order_acquire);
+        T item = r->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return StealStatus::Contended;
+        }
+        out = item;
+        return StealStatus::Success;
+    }
+
+    /// Approximate number of elements (exact when called by the owner with no concurrent thief).
+    int64_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+private:
+    struct Ring {
+        explicit Ring(int64_t size) : mask(size - 1), slots(new std::atomic<T>[size]) {}
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+        T get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T item) { slots[i & mask].store(item, std::memory_order_relaxed); }
+    };
+
+    Ring* grow(Ring* old, int64_t t, int64_t b) {
+        rings.emplace_back(new Ring((old->mask + 1) * 2));
+        Ring* bigger = rings.back().get();
+        for (int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> top{0};     ///< Next element to steal.
+    alignas(64) std::atomic<int64_t> bottom{0};  ///< Next free position (owner side).
+    std::atomic<Ring*> ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings;    ///< Every ring ever used (owner side).
+};
+
+#endif // WORKSTEALINGDEQUE_HPP
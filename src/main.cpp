@@ -4,16 +4,17 @@
 #include "../src/Network/Server.hpp"
 #include "../src/Network/Server_LF.hpp"
 #include "../src/Network/Server_PL.hpp"
+#include "../src/Network/Server_EV.hpp"
 
 int main(int argc, char* argv[]) {
     // Default configuration values (injected via CMake)
-    std::string mode = DEFAULT_MODE; // Default server mode (e.g., -LF or -PL)
+    std::string mode = DEFAULT_MODE; // Default server mode (e.g., -LF, -PL or -EV)
     int port = DEFAULT_PORT;         // Default port number
     int num_threads = 4;             // Default number of threads for multi-threaded servers
 
     // Process command-line arguments provided by the user
     if (argc >= 2) {
-        mode = argv[1]; // Set mode to user input (e.g., -LF or -PL)
+        mode = argv[1]; // Set mode to user input (e.g., -LF, -PL or -EV)
     }
     if (argc >= 3) {
         try {
@@ -52,10 +53,16 @@ int main(int argc, char* argv[]) {
         std::cout << "Starting Pipeline server on port " << port << "..." << std::endl;
         server = std::make_unique<Server_PL>("127.0.0.1", port);
     }
+    else if (mode == "-EV") {
+        // If the mode is Event-driven (-EV), create an epoll reactor with a pool of worker threads
+        std::cout << "Starting Event-driven server on port " << port
+                  << " with " << num_threads << " worker threads..." << std::endl;
+        server = std::make_unique<Server_EV>("127.0.0.1", port, num_threads);
+    }
     else {
         // Handle invalid mode input
         std::cerr << "Unknown mode: " << mode << std::endl;
-        std::cerr << "Usage: " << argv[0] << " -PL|-LF [<num_threads>] [<port>]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " -PL|-LF|-EV [<num_threads>] [<port>]" << std::endl;
         return 1; // Exit with error code
     }
 